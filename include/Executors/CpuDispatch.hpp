@@ -0,0 +1,131 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "Executor.hpp"
+#include <cstdlib>
+#include <cstring>
+
+// Define STEALTH_NO_CPU_DISPATCH to compile kernels for the build's target only.
+#if !defined(STEALTH_NO_CPU_DISPATCH) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define STEALTH_CPU_DISPATCH
+    // Multiplies and adds are never contracted into FMAs, which AVX-512 implies, so every instruction set
+    // rounds exactly as the baseline does. Clang only contracts within a single source expression, which
+    // the element-wise operators never span, and does not support the attribute.
+    #ifdef __clang__
+        #define STEALTH_NO_CONTRACT
+    #else
+        #define STEALTH_NO_CONTRACT optimize("fp-contract=off"),
+    #endif
+    // Compiles a function for the given instruction set, with everything it calls inlined so that the
+    // whole kernel is compiled for it as well.
+    #define STEALTH_TARGET(isa) __attribute__((target(isa), STEALTH_NO_CONTRACT flatten))
+#endif
+
+namespace Stealth::Tensor {
+    // Instruction sets that the evaluation kernels are compiled for, from least to most capable.
+    enum class InstructionSet {
+        Baseline,
+        AVX2,
+        AVX512
+    };
+
+    namespace internal {
+        constexpr STEALTH_ALWAYS_INLINE InstructionSet min_instruction_set(InstructionSet lhs, InstructionSet rhs) noexcept {
+            return static_cast<int>(lhs) <= static_cast<int>(rhs) ? lhs : rhs;
+        }
+
+        // The most capable instruction set the CPU supports, from CPUID.
+        inline InstructionSet detect_instruction_set() noexcept {
+            #ifdef STEALTH_CPU_DISPATCH
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("avx512f") and __builtin_cpu_supports("avx512bw")
+                    and __builtin_cpu_supports("avx512dq") and __builtin_cpu_supports("avx512vl")) {
+                    return InstructionSet::AVX512;
+                }
+                if (__builtin_cpu_supports("avx2")) return InstructionSet::AVX2;
+            #endif
+            return InstructionSet::Baseline;
+        }
+
+        // Parses baseline, avx2 or avx512, returning fallback for anything else.
+        inline InstructionSet parse_instruction_set(const char* name, InstructionSet fallback) noexcept {
+            if (not name) return fallback;
+            if (std::strcmp(name, "baseline") == 0) return InstructionSet::Baseline;
+            if (std::strcmp(name, "avx2") == 0) return InstructionSet::AVX2;
+            if (std::strcmp(name, "avx512") == 0) return InstructionSet::AVX512;
+            return fallback;
+        }
+
+        inline InstructionSet supported_instruction_set() noexcept {
+            static const InstructionSet supported = detect_instruction_set();
+            return supported;
+        }
+
+        // Chosen once, on first use. STEALTH_INSTRUCTION_SET can lower it, so that every path can be
+        // exercised on a single machine.
+        inline InstructionSet& instruction_set() noexcept {
+            static InstructionSet instructionSet = min_instruction_set(
+                parse_instruction_set(std::getenv("STEALTH_INSTRUCTION_SET"), supported_instruction_set()),
+                supported_instruction_set());
+            return instructionSet;
+        }
+    } /* internal */
+
+    inline InstructionSet supportedInstructionSet() noexcept {
+        return internal::supported_instruction_set();
+    }
+
+    inline InstructionSet currentInstructionSet() noexcept {
+        return internal::instruction_set();
+    }
+
+    // Selects the instruction set for kernels started from now on, limited to what the CPU supports,
+    // and returns the one selected. Must not be called while kernels are running.
+    inline InstructionSet setInstructionSet(InstructionSet instructionSet) noexcept {
+        internal::instruction_set() = internal::min_instruction_set(instructionSet, supportedInstructionSet());
+        return internal::instruction_set();
+    }
+
+    namespace internal {
+        #ifdef STEALTH_CPU_DISPATCH
+            template <typename Body, typename Index>
+            STEALTH_TARGET("avx2") void run_avx2(const Body& body, Index begin, Index end) {
+                body(begin, end);
+            }
+
+            template <typename Body, typename Index>
+            STEALTH_TARGET("avx512f,avx512bw,avx512dq,avx512vl") void run_avx512(const Body& body, Index begin, Index end) {
+                body(begin, end);
+            }
+        #endif
+
+        // Calls body(begin, end), compiled for the selected instruction set.
+        template <typename Body, typename Index>
+        inline void dispatch_range(const Body& body, Index begin, Index end) {
+            #ifdef STEALTH_CPU_DISPATCH
+                switch (instruction_set()) {
+                    case InstructionSet::AVX512: return run_avx512(body, begin, end);
+                    case InstructionSet::AVX2: return run_avx2(body, begin, end);
+                    case InstructionSet::Baseline: break;
+                }
+            #endif
+            body(begin, end);
+        }
+
+        // parallel_for for the heavy evaluation kernels. Every range runs a copy of body compiled for the
+        // selected instruction set, so a binary built for the baseline still uses wider vectors where it can.
+        template <typename Body>
+        inline void parallel_for_dispatch(int begin, int end, int grain, const Body& body) {
+            parallel_for(begin, end, grain, [&body](int rangeBegin, int rangeEnd) {
+                dispatch_range(body, rangeBegin, rangeEnd);
+            });
+        }
+
+        // As above, for parallel_for_flat.
+        template <typename Index, typename Body>
+        inline void parallel_for_flat_dispatch(Index size, int grain, const Body& body) {
+            parallel_for_flat(size, grain, [&body](Index rangeBegin, Index rangeEnd) {
+                dispatch_range(body, rangeBegin, rangeEnd);
+            });
+        }
+    } /* internal */
+} /* Stealth::Tensor */
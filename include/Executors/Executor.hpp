@@ -0,0 +1,129 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include <algorithm>
+#include <type_traits>
+
+namespace Stealth::Tensor {
+    // Non-owning reference to a callable taking a half-open [begin, end) range.
+    class RangeFunction {
+        public:
+            template <typename Callable>
+            constexpr STEALTH_ALWAYS_INLINE RangeFunction(const Callable& callable) noexcept
+                : mCallable{&callable}, mInvoke{[](const void* callable, int begin, int end) {
+                    (*static_cast<const Callable*>(callable))(begin, end);
+                }} { }
+
+            STEALTH_ALWAYS_INLINE void operator()(int begin, int end) const {
+                mInvoke(mCallable, begin, end);
+            }
+        private:
+            const void* mCallable;
+            void (*mInvoke)(const void*, int, int);
+    };
+
+    // All evaluation kernels split their outer loop into ranges and hand them to an Executor, including scans,
+    // summed-area tables, pyramids and scatters. To run kernels on another thread pool, derive from this and
+    // install it with setDefaultExecutor() or an ExecutorScope.
+    class Executor {
+        public:
+            virtual ~Executor() = default;
+            // Must call body on disjoint ranges covering [begin, end) and return once all of them are done.
+            // Ranges should not be split below grain elements.
+            virtual void parallelFor(int begin, int end, int grain, RangeFunction body) = 0;
+    };
+
+    // Runs everything on the calling thread.
+    class SerialExecutor : public Executor {
+        public:
+            void parallelFor(int begin, int end, int, RangeFunction body) override {
+                if (begin < end) body(begin, end);
+            }
+    };
+
+    // Statically partitions ranges across the OpenMP thread team. This is the default.
+    class OpenMPExecutor : public Executor {
+        public:
+            void parallelFor(int begin, int end, int grain, RangeFunction body) override {
+                const int numChunks = (end - begin + grain - 1) / grain;
+                #pragma omp parallel for schedule(static)
+                for (int chunk = 0; chunk < numChunks; ++chunk) {
+                    const int chunkBegin = begin + chunk * grain;
+                    body(chunkBegin, std::min(end, chunkBegin + grain));
+                }
+            }
+    };
+
+    namespace internal {
+        // Kernels hand out at least this many elements to each range.
+        constexpr int kPARALLEL_GRAIN_SIZE = 4096;
+
+        inline Executor*& default_executor() noexcept {
+            static OpenMPExecutor openmp;
+            static Executor* executor = &openmp;
+            return executor;
+        }
+
+        inline Executor*& thread_executor() noexcept {
+            static thread_local Executor* executor = nullptr;
+            return executor;
+        }
+
+        // Grain size, in rows, for kernels whose outer loop is over rows of the given width.
+        constexpr STEALTH_ALWAYS_INLINE int row_grain(int width) noexcept {
+            return std::max(1, kPARALLEL_GRAIN_SIZE / std::max(1, width));
+        }
+    } /* internal */
+
+    // The executor installed for this thread, or the process-wide default.
+    inline Executor& currentExecutor() noexcept {
+        Executor* executor = internal::thread_executor();
+        return executor ? *executor : *internal::default_executor();
+    }
+
+    inline void setDefaultExecutor(Executor& executor) noexcept {
+        internal::default_executor() = &executor;
+    }
+
+    // Installs an executor for the current thread until the end of the scope.
+    class ExecutorScope {
+        public:
+            explicit ExecutorScope(Executor& executor) noexcept : mPrevious{internal::thread_executor()} {
+                internal::thread_executor() = &executor;
+            }
+
+            ~ExecutorScope() {
+                internal::thread_executor() = mPrevious;
+            }
+
+            ExecutorScope(const ExecutorScope&) = delete;
+            ExecutorScope& operator=(const ExecutorScope&) = delete;
+        private:
+            Executor* mPrevious;
+    };
+
+    namespace internal {
+        template <typename Body>
+        inline void parallel_for(int begin, int end, int grain, const Body& body) {
+            // Not worth dispatching work that would not be split anyway.
+            if (end - begin <= grain) {
+                if (begin < end) body(begin, end);
+                return;
+            }
+            currentExecutor().parallelFor(begin, end, grain, RangeFunction{body});
+        }
+
+        // parallel_for over the flat range [0, size), which may hold more elements than int can count, in
+        // which case whole grains are handed out and body receives 64-bit bounds.
+        template <typename Index, typename Body>
+        inline void parallel_for_flat(Index size, int grain, const Body& body) {
+            if constexpr (std::is_same<Index, int>::value) {
+                parallel_for(0, size, grain, body);
+            } else {
+                const int numGrains = static_cast<int>((size + grain - 1) / grain);
+                parallel_for(0, numGrains, 1, [size, grain, &body](int firstGrain, int lastGrain) {
+                    body(Index{firstGrain} * grain, std::min(Index{lastGrain} * grain, size));
+                });
+            }
+        }
+    } /* internal */
+} /* Stealth::Tensor */
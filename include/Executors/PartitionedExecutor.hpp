@@ -0,0 +1,43 @@
+#pragma once
+#include "Executor.hpp"
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
+
+namespace Stealth::Tensor {
+    // Splits every range into one contiguous slab per OpenMP thread, so thread t always covers the
+    // same fraction of a tensor, whichever kernel is running. Install it before allocating large
+    // tensors and run with pinned threads (e.g. OMP_PROC_BIND=spread OMP_PLACES=cores): the pages a
+    // thread first-touches during allocation are then the ones it reads and writes during evaluation,
+    // and stay on its own NUMA node.
+    class PartitionedExecutor : public Executor {
+        public:
+            // A numThreads of 0 uses the OpenMP default.
+            explicit PartitionedExecutor(int numThreads = 0) noexcept : mNumThreads{numThreads} { }
+
+            void parallelFor(int begin, int end, int grain, RangeFunction body) override {
+                if (begin >= end) return;
+                #ifdef _OPENMP
+                    const int maxSlabs = (end - begin + grain - 1) / std::max(1, grain);
+                    const int numThreads = std::min(maxSlabs, mNumThreads > 0 ? mNumThreads : omp_get_max_threads());
+                    #pragma omp parallel num_threads(numThreads)
+                    {
+                        const int numSlabs = omp_get_num_threads(), slab = omp_get_thread_num();
+                        const auto boundary = [begin, end, numSlabs](int index) {
+                            return begin + static_cast<int>(static_cast<long long>(end - begin) * index / numSlabs);
+                        };
+                        const int slabBegin = boundary(slab), slabEnd = boundary(slab + 1);
+                        if (slabBegin < slabEnd) body(slabBegin, slabEnd);
+                    }
+                #else
+                    body(begin, end);
+                #endif
+            }
+
+            int numThreads() const noexcept {
+                return mNumThreads;
+            }
+        private:
+            int mNumThreads;
+    };
+} /* Stealth::Tensor */
@@ -0,0 +1,153 @@
+#pragma once
+#include "Executor.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Stealth::Tensor {
+    // Thread pool in which every worker owns a deque of ranges. Workers split their range in half
+    // until it reaches the grain size, pushing the upper halves onto their own deque where idle
+    // workers can steal them. The calling thread takes part in the work. Calls made from inside
+    // one of the pool's own workers run inline, so nested evaluation never oversubscribes.
+    class WorkStealingExecutor : public Executor {
+        struct Job {
+            RangeFunction body;
+            int grain;
+            std::atomic<int> remaining;
+        };
+
+        struct Task {
+            Job* job;
+            int begin, end;
+        };
+
+        struct alignas(64) WorkerQueue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        public:
+            explicit WorkStealingExecutor(int numThreads = std::max(1u, std::thread::hardware_concurrency()))
+                : mQueues(numThreads) {
+                // Every queue must exist before any worker starts stealing.
+                for (int i = 0; i < numThreads; ++i) {
+                    mQueues[i] = std::make_unique<WorkerQueue>();
+                }
+                // The last queue belongs to whichever thread is calling parallelFor.
+                for (int i = 0; i < numThreads - 1; ++i) {
+                    mWorkers.emplace_back([this, i] { workerLoop(i); });
+                }
+            }
+
+            ~WorkStealingExecutor() override {
+                {
+                    std::lock_guard<std::mutex> lock{mSleepMutex};
+                    mStop = true;
+                }
+                mWake.notify_all();
+                for (std::thread& worker : mWorkers) worker.join();
+            }
+
+            WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+            WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+            int numThreads() const noexcept {
+                return static_cast<int>(mQueues.size());
+            }
+
+            void parallelFor(int begin, int end, int grain, RangeFunction body) override {
+                if (begin >= end) return;
+                if (tCurrentPool == this or mWorkers.empty()) {
+                    body(begin, end);
+                    return;
+                }
+                // Only one external caller at a time owns the caller queue.
+                std::lock_guard<std::mutex> callerLock{mCallerMutex};
+                const int self = numThreads() - 1;
+                Job job{body, std::max(1, grain), {end - begin}};
+                const Executor* previousPool = tCurrentPool;
+                tCurrentPool = this;
+                push(self, Task{&job, begin, end});
+                while (job.remaining.load(std::memory_order_acquire) > 0) {
+                    Task task;
+                    if (pop(self, task) or steal(self, task)) run(self, task);
+                    else std::this_thread::yield();
+                }
+                tCurrentPool = previousPool;
+            }
+
+        private:
+            static inline thread_local const Executor* tCurrentPool = nullptr;
+
+            std::vector<std::unique_ptr<WorkerQueue>> mQueues;
+            std::vector<std::thread> mWorkers;
+            std::atomic<int> mQueued{0};
+            std::mutex mCallerMutex, mSleepMutex;
+            std::condition_variable mWake;
+            bool mStop = false;
+
+            void push(int self, const Task& task) {
+                {
+                    std::lock_guard<std::mutex> lock{mQueues[self] -> mutex};
+                    mQueues[self] -> tasks.push_back(task);
+                }
+                if (mQueued.fetch_add(1, std::memory_order_release) == 0) {
+                    std::lock_guard<std::mutex> lock{mSleepMutex};
+                }
+                mWake.notify_one();
+            }
+
+            // The owner works from the back, where the most recently split (and smallest) ranges are.
+            bool pop(int self, Task& task) {
+                std::lock_guard<std::mutex> lock{mQueues[self] -> mutex};
+                if (mQueues[self] -> tasks.empty()) return false;
+                task = mQueues[self] -> tasks.back();
+                mQueues[self] -> tasks.pop_back();
+                mQueued.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            // Thieves take from the front, where the largest ranges are.
+            bool steal(int self, Task& task) {
+                const int numQueues = numThreads();
+                for (int offset = 1; offset < numQueues; ++offset) {
+                    WorkerQueue& victim = *mQueues[(self + offset) % numQueues];
+                    std::lock_guard<std::mutex> lock{victim.mutex};
+                    if (victim.tasks.empty()) continue;
+                    task = victim.tasks.front();
+                    victim.tasks.pop_front();
+                    mQueued.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+                return false;
+            }
+
+            void run(int self, Task task) {
+                while (task.end - task.begin > task.job -> grain) {
+                    const int middle = task.begin + (task.end - task.begin) / 2;
+                    push(self, Task{task.job, middle, task.end});
+                    task.end = middle;
+                }
+                task.job -> body(task.begin, task.end);
+                task.job -> remaining.fetch_sub(task.end - task.begin, std::memory_order_release);
+            }
+
+            void workerLoop(int self) {
+                tCurrentPool = this;
+                while (true) {
+                    Task task;
+                    if (pop(self, task) or steal(self, task)) {
+                        run(self, task);
+                        continue;
+                    }
+                    std::unique_lock<std::mutex> lock{mSleepMutex};
+                    mWake.wait(lock, [this] { return mStop or mQueued.load(std::memory_order_acquire) > 0; });
+                    if (mStop) return;
+                }
+            }
+    };
+} /* Stealth::Tensor */
@@ -2,12 +2,21 @@
 #include "../core/ForwardDeclarations.hpp"
 #include "../core/Tensor3Base.hpp"
 #include "../utils.hpp"
+#include "../Executors/CpuDispatch.hpp"
+#include "../Executors/Executor.hpp"
+#include <array>
+#include <limits>
 
 namespace Stealth::Tensor {
     namespace {
         template <int width, int length, int height, typename LHS>
         constexpr STEALTH_ALWAYS_INLINE auto optimal_indexing_mode() noexcept {
-            if constexpr (height == 1 && length == 1) {
+            if constexpr (internal::traits<LHS>::indexingMode == 3
+                or internal::traits<LHS>::size > std::numeric_limits<int>::max()) {
+                // Views of tiled layouts, or anything else that can only be addressed by coordinates. The
+                // offsets into tensors beyond INT_MAX elements do not fit in the int accessors either.
+                return 3;
+            } else if constexpr (height == 1 && length == 1) {
                 // 1D Views always use 1D indexing.
                 return 1;
             } else if constexpr (height == 1) {
@@ -45,10 +54,10 @@ namespace Stealth::Tensor {
             static constexpr int length = lengthAtCompileTime,
                 width = widthAtCompileTime,
                 height = heightAtCompileTime,
-                area = length * width,
-                size = area * height,
                 indexingMode = std::max(optimal_indexing_mode<width, length, height, LHS>(),
                     internal::traits<LHS>::indexingMode);
+            static constexpr long long area = static_cast<long long>(length) * width,
+                size = area * height;
             using StoredLHS = expr_ref<LHS>;
             static constexpr bool is_scalar = size == 1;
             static constexpr bool is_vector = !is_scalar and (width == size or length == size or height == size);
@@ -60,24 +69,55 @@ namespace Stealth::Tensor {
     class BlockExpr : public Tensor3Base<BlockExpr<widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime, LHS>> {
         public:
             using StoredLHS = typename internal::traits<BlockExpr>::StoredLHS;
+            using IndexType = internal::index_type<internal::traits<LHS>::size>;
 
             constexpr STEALTH_ALWAYS_INLINE BlockExpr(LHS&& otherTensor3, int x = 0, int y = 0, int z = 0) noexcept
                 : tensor3{otherTensor3}, minX{x}, minY{y}, minZ{z},
-                offset{minX + minY * tensor3.width() + minZ * tensor3.area()},
-                offsetXZ{minX + minZ * tensor3.area()} {
+                offset{static_cast<IndexType>(minX + static_cast<long long>(minY) * tensor3.width() + minZ * tensor3.area())},
+                offsetXZ{static_cast<IndexType>(minX + minZ * tensor3.area())} {
                 #ifdef DEBUG
                     debugType<StoredLHS>();
                 #endif
             }
 
+            // Copies are views of the same elements, as expressions store them.
+            constexpr BlockExpr(const BlockExpr&) = default;
+
+            // Assignment writes through to the underlying Tensor3.
+            constexpr STEALTH_ALWAYS_INLINE BlockExpr& operator=(const BlockExpr& other) {
+                assign(other);
+                return *this;
+            }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE BlockExpr& operator=(const OtherTensor3& other) {
+                assign(other);
+                return *this;
+            }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void operator+=(OtherTensor3&& other) {
+                assign((*this) + std::forward<OtherTensor3&&>(other));
+            }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void operator-=(OtherTensor3&& other) {
+                assign((*this) - std::forward<OtherTensor3&&>(other));
+            }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void operator/=(OtherTensor3&& other) {
+                assign((*this) / std::forward<OtherTensor3&&>(other));
+            }
+
             constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y, int z)
                 -> typename std::invoke_result<StoredLHS, int, int, int>::type {
                 return tensor3(x + minX, y + minY, z + minZ);
             }
 
             constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y, int z) const
-                -> typename std::invoke_result<StoredLHS, int, int, int>::type {
-                return tensor3(x + minX, y + minY, z + minZ);
+                -> typename std::invoke_result<const raw_type<StoredLHS>&, int, int, int>::type {
+                return std::as_const(tensor3)(x + minX, y + minY, z + minZ);
             }
 
             constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y)
@@ -86,8 +126,8 @@ namespace Stealth::Tensor {
             }
 
             constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y) const
-                -> typename std::invoke_result<StoredLHS, int, int>::type {
-                return tensor3(x + offsetXZ, y + minY);
+                -> typename std::invoke_result<const raw_type<StoredLHS>&, int, int>::type {
+                return std::as_const(tensor3)(x + offsetXZ, y + minY);
             }
 
             constexpr STEALTH_ALWAYS_INLINE auto operator()(int x)
@@ -96,8 +136,8 @@ namespace Stealth::Tensor {
             }
 
             constexpr STEALTH_ALWAYS_INLINE auto operator()(int x) const
-                -> typename std::invoke_result<StoredLHS, int>::type {
-                return tensor3(x + offset);
+                -> typename std::invoke_result<const raw_type<StoredLHS>&, int>::type {
+                return std::as_const(tensor3)(x + offset);
             }
 
             constexpr STEALTH_ALWAYS_INLINE auto data() const noexcept {
@@ -116,9 +156,45 @@ namespace Stealth::Tensor {
                 return tensor3;
             }
 
+            constexpr STEALTH_ALWAYS_INLINE std::array<int, 3> offsets() const noexcept {
+                return {minX, minY, minZ};
+            }
+
         private:
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void assign(const OtherTensor3& other) {
+                if constexpr (internal::traits<LHS>::exprType == internal::ExpressionType::TrackedTensor3) {
+                    // Mark the whole block once rather than on every write.
+                    tensor3.markDirty(Region{minX, minY, minZ, minX + widthAtCompileTime, minY + lengthAtCompileTime,
+                        minZ + heightAtCompileTime});
+                    assign_impl(tensor3.untracked(), other);
+                } else {
+                    assign_impl(tensor3, other);
+                }
+            }
+
+            template <typename Target, typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void assign_impl(Target& target, const OtherTensor3& other) {
+                if constexpr (!std::is_scalar<OtherTensor3>::value) {
+                    static_assert(internal::traits<OtherTensor3>::size == BlockExpr::size(),
+                        "Cannot assign incompatible Tensor3 to BlockExpr");
+                }
+                internal::parallel_for_dispatch(0, lengthAtCompileTime * heightAtCompileTime, internal::row_grain(widthAtCompileTime),
+                    [this, &target, &other](int begin, int end) {
+                        for (int row = begin; row < end; ++row) {
+                            const int y = row % lengthAtCompileTime;
+                            const int z = row / lengthAtCompileTime;
+                            #pragma omp simd
+                            for (int x = 0; x < widthAtCompileTime; ++x) {
+                                if constexpr (std::is_scalar<OtherTensor3>::value) target(x + minX, y + minY, z + minZ) = other;
+                                else target(x + minX, y + minY, z + minZ) = other(x, y, z);
+                            }
+                        }
+                    });
+            }
+
             const int minX, minY, minZ;
-            const int offset, offsetXZ;
+            const IndexType offset, offsetXZ;
             StoredLHS tensor3;
     };
 
@@ -11,12 +11,12 @@ namespace Stealth::Tensor {
             constexpr int intrinsicIndexingMode = std::max(internal::traits<LHS>::indexingMode,
                 internal::traits<RHS>::indexingMode);
             // Now figure out what broadcasting would require.
-            constexpr int lhsLength = internal::traits<LHS>::length,
-                lhsSize = internal::traits<LHS>::size;
+            constexpr int lhsLength = internal::traits<LHS>::length;
+            constexpr long long lhsSize = internal::traits<LHS>::size;
             constexpr bool lhs_is_scalar = internal::traits<LHS>::is_scalar;
             // RHS
-            constexpr int rhsLength = internal::traits<RHS>::length,
-                rhsSize = internal::traits<RHS>::size;
+            constexpr int rhsLength = internal::traits<RHS>::length;
+            constexpr long long rhsSize = internal::traits<RHS>::size;
             constexpr bool rhs_is_scalar = internal::traits<RHS>::is_scalar;
             // If dimensions match or either value is a scalar, we can index in 1D.
             if constexpr (lhs_is_scalar or rhs_is_scalar or lhsSize == rhsSize) {
@@ -35,16 +35,16 @@ namespace Stealth::Tensor {
             // Check if these Tensor3s can be operated on correctly.
             constexpr int lhsWidth = internal::traits<LHS>::width,
                 lhsLength = internal::traits<LHS>::length,
-                lhsHeight = internal::traits<LHS>::height,
-                lhsSize = internal::traits<LHS>::size;
+                lhsHeight = internal::traits<LHS>::height;
+            constexpr long long lhsSize = internal::traits<LHS>::size;
             constexpr bool lhs_is_scalar = internal::traits<LHS>::is_scalar,
                 lhs_is_vector = internal::traits<LHS>::is_vector,
                 lhs_is_matrix = internal::traits<LHS>::is_matrix;
             // RHS
             constexpr int rhsWidth = internal::traits<RHS>::width,
                 rhsLength = internal::traits<RHS>::length,
-                rhsHeight = internal::traits<RHS>::height,
-                rhsSize = internal::traits<RHS>::size;
+                rhsHeight = internal::traits<RHS>::height;
+            constexpr long long rhsSize = internal::traits<RHS>::size;
             constexpr bool rhs_is_scalar = internal::traits<RHS>::is_scalar,
                 rhs_is_vector = internal::traits<RHS>::is_vector,
                 rhs_is_matrix = internal::traits<RHS>::is_matrix;
@@ -78,9 +78,9 @@ namespace Stealth::Tensor {
             static constexpr int length = std::max(internal::traits<LHS>::length, internal::traits<RHS>::length),
                 width = std::max(internal::traits<LHS>::width, internal::traits<RHS>::width),
                 height = std::max(internal::traits<LHS>::height, internal::traits<RHS>::height),
-                area = std::max(internal::traits<LHS>::area, internal::traits<RHS>::area),
-                size = std::max(internal::traits<LHS>::size, internal::traits<RHS>::size),
                 indexingMode = optimal_indexing_mode<LHS, RHS>();
+            static constexpr long long area = std::max(internal::traits<LHS>::area, internal::traits<RHS>::area),
+                size = std::max(internal::traits<LHS>::size, internal::traits<RHS>::size);
             using StoredLHS = expr_ref<LHS>;
             using StoredRHS = expr_ref<RHS>;
             static constexpr bool is_scalar = size == 1;
@@ -120,26 +120,48 @@ namespace Stealth::Tensor {
             constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y, int z) const {
                 // We can broadcast single points, 1D vectors, as well as 2D matrixs over 3D cubes.
                 return op(
-                    lhs((lhs.width() == 1) ? 0 : x, (lhs.length() == 1) ? 0 : y, (lhs.height() == 1) ? 0 : z),
-                    rhs((rhs.width() == 1) ? 0 : x, (rhs.length() == 1) ? 0 : y, (rhs.height() == 1) ? 0 : z)
+                    std::as_const(lhs)((lhs.width() == 1) ? 0 : x, (lhs.length() == 1) ? 0 : y,
+                        (lhs.height() == 1) ? 0 : z),
+                    std::as_const(rhs)((rhs.width() == 1) ? 0 : x, (rhs.length() == 1) ? 0 : y,
+                        (rhs.height() == 1) ? 0 : z)
                 );
             }
 
             constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y) const {
                 // We can broadcast single points and 1D vectors across 2D matrixs
                 return op(
-                    lhs((lhs.width() == 1) ? 0 : x, (lhs.length() == 1) ? 0 : y),
-                    rhs((rhs.width() == 1) ? 0 : x, (rhs.length() == 1) ? 0 : y)
+                    std::as_const(lhs)((lhs.width() == 1) ? 0 : x, (lhs.length() == 1) ? 0 : y),
+                    std::as_const(rhs)((rhs.width() == 1) ? 0 : x, (rhs.length() == 1) ? 0 : y)
                 );
             }
 
             constexpr STEALTH_ALWAYS_INLINE auto operator()(int x) const {
                 // We can broadcast scalars across 1D vectors.
                 return op(
-                    lhs((lhs.width() == 1) ? 0 : x),
-                    rhs((rhs.width() == 1) ? 0 : x)
+                    std::as_const(lhs)((lhs.width() == 1) ? 0 : x),
+                    std::as_const(rhs)((rhs.width() == 1) ? 0 : x)
                 );
             }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& lhsExpr() const noexcept {
+                return lhs;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& rhsExpr() const noexcept {
+                return rhs;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto& lhsExpr() noexcept {
+                return lhs;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto& rhsExpr() noexcept {
+                return rhs;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& operation() const noexcept {
+                return op;
+            }
         private:
             StoredLHS lhs;
             expr_ref<BinaryOperation> op;
@@ -15,9 +15,9 @@ namespace Stealth::Tensor {
             static constexpr int length = internal::traits<LHS>::length,
                 width = internal::traits<LHS>::width,
                 height = internal::traits<LHS>::height,
-                area = internal::traits<LHS>::area,
-                size = internal::traits<LHS>::size,
                 indexingMode = internal::traits<LHS>::indexingMode;
+            static constexpr long long area = internal::traits<LHS>::area,
+                size = internal::traits<LHS>::size;
             using StoredLHS = expr_ref<LHS>;
             static constexpr bool is_scalar = size == 1;
             static constexpr bool is_vector = !is_scalar and (width == size or length == size or height == size);
@@ -35,15 +35,23 @@ namespace Stealth::Tensor {
                 : op{std::forward<UnaryOperation&&>(op)}, lhs{std::forward<LHS&&>(lhs)} { }
 
             constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y, int z) const {
-                return op(lhs(x, y, z));
+                return op(std::as_const(lhs)(x, y, z));
             }
 
             constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y) const {
-                return op(lhs(x, y));
+                return op(std::as_const(lhs)(x, y));
             }
 
             constexpr STEALTH_ALWAYS_INLINE auto operator()(int x) const {
-                return op(lhs(x));
+                return op(std::as_const(lhs)(x));
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& lhsExpr() const noexcept {
+                return lhs;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto& lhsExpr() noexcept {
+                return lhs;
             }
 
         private:
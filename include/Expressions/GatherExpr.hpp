@@ -0,0 +1,59 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../core/Tensor3Base.hpp"
+#include "../utils.hpp"
+#include <type_traits>
+
+namespace Stealth::Tensor {
+    namespace internal {
+        template <typename Table, typename Indices>
+        struct traits<GatherExpr<Table, Indices>> {
+            static constexpr ExpressionType exprType = ExpressionType::GatherExpr;
+            using ScalarType = typename internal::traits<Table>::ScalarType;
+            // The result has the shape of the indices.
+            static constexpr int length = internal::traits<Indices>::length,
+                width = internal::traits<Indices>::width,
+                height = internal::traits<Indices>::height,
+                indexingMode = internal::traits<Indices>::indexingMode;
+            static constexpr long long area = internal::traits<Indices>::area,
+                size = internal::traits<Indices>::size;
+            using StoredTable = expr_ref<Table>;
+            using StoredIndices = expr_ref<Indices>;
+            static constexpr bool is_scalar = size == 1;
+            static constexpr bool is_vector = !is_scalar and (width == size or length == size or height == size);
+            static constexpr bool is_matrix = !is_vector and (width == 1 or length == 1 or height == 1);
+        };
+    } /* internal */
+
+    // Indices are flat indices into the table. Since every access goes through the indices, the simd
+    // copy loops turn the table loads into hardware gathers where the target supports them.
+    template <typename Table, typename Indices>
+    class GatherExpr : public Tensor3Base<GatherExpr<Table, Indices>> {
+        using StoredTable = typename internal::traits<GatherExpr>::StoredTable;
+        using StoredIndices = typename internal::traits<GatherExpr>::StoredIndices;
+
+        public:
+            constexpr STEALTH_ALWAYS_INLINE GatherExpr(Table&& table, Indices&& indices) noexcept
+                : table{std::forward<Table&&>(table)}, indices{std::forward<Indices&&>(indices)} {
+                static_assert(internal::traits<Table>::indexingMode == 1, "Lookup tables must be contiguous");
+                static_assert(std::is_integral<typename internal::traits<Indices>::ScalarType>::value,
+                    "Cannot gather using non-integral indices");
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y, int z) const {
+                return std::as_const(table)(static_cast<int>(std::as_const(indices)(x, y, z)));
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y) const {
+                return std::as_const(table)(static_cast<int>(std::as_const(indices)(x, y)));
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x) const {
+                return std::as_const(table)(static_cast<int>(std::as_const(indices)(x)));
+            }
+
+        private:
+            StoredTable table;
+            StoredIndices indices;
+    };
+} /* Stealth::Tensor */
@@ -0,0 +1,118 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../core/Tensor3Base.hpp"
+#include "../utils.hpp"
+
+namespace Stealth::Tensor {
+    namespace {
+        template <int axis, typename LHS>
+        constexpr STEALTH_ALWAYS_INLINE int axis_dimension() noexcept {
+            if constexpr (axis == 0) return internal::traits<LHS>::width;
+            else if constexpr (axis == 1) return internal::traits<LHS>::length;
+            else return internal::traits<LHS>::height;
+        }
+
+        template <int axisX, int axisY, int axisZ, typename LHS>
+        constexpr STEALTH_ALWAYS_INLINE auto permuted_indexing_mode() noexcept {
+            if constexpr (axisX == 0 && axisY == 1 && axisZ == 2) {
+                // The identity permutation can index the underlying expression directly.
+                return internal::traits<LHS>::indexingMode;
+            } else if constexpr (axis_dimension<axisY, LHS>() == 1 && axis_dimension<axisZ, LHS>() == 1) {
+                return 1;
+            } else if constexpr (axis_dimension<axisZ, LHS>() == 1) {
+                return 2;
+            } else {
+                return 3;
+            }
+        }
+    }
+
+    namespace internal {
+        template <int axisX, int axisY, int axisZ, typename LHS>
+        struct traits<PermuteExpr<axisX, axisY, axisZ, LHS>> {
+            static constexpr ExpressionType exprType = ExpressionType::PermuteExpr;
+            using ScalarType = typename internal::traits<LHS>::ScalarType;
+            // Dimensions
+            static constexpr int width = axis_dimension<axisX, LHS>(),
+                length = axis_dimension<axisY, LHS>(),
+                height = axis_dimension<axisZ, LHS>(),
+                indexingMode = permuted_indexing_mode<axisX, axisY, axisZ, LHS>();
+            static constexpr long long area = static_cast<long long>(length) * width,
+                size = area * height;
+            using StoredLHS = expr_ref<LHS>;
+            static constexpr bool is_scalar = size == 1;
+            static constexpr bool is_vector = !is_scalar and (width == size or length == size or height == size);
+            static constexpr bool is_matrix = !is_vector and (width == 1 or length == 1 or height == 1);
+        };
+    } /* internal */
+
+    // Axis i of the view is axis axis_i of the underlying expression.
+    template <int axisX, int axisY, int axisZ, typename LHS>
+    class PermuteExpr : public Tensor3Base<PermuteExpr<axisX, axisY, axisZ, LHS>> {
+        static constexpr bool isIdentity = (axisX == 0 && axisY == 1 && axisZ == 2);
+
+        public:
+            using StoredLHS = typename internal::traits<PermuteExpr>::StoredLHS;
+
+            constexpr STEALTH_ALWAYS_INLINE PermuteExpr(LHS&& otherTensor3) noexcept
+                : tensor3{otherTensor3} {
+                static_assert(axisX != axisY and axisY != axisZ and axisX != axisZ
+                    and axisX >= 0 and axisY >= 0 and axisZ >= 0 and axisX < 3 and axisY < 3 and axisZ < 3,
+                    "Axes must be a permutation of 0, 1, 2");
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y, int z)
+                -> typename std::invoke_result<StoredLHS, int, int, int>::type {
+                return tensor3(source<0>(x, y, z), source<1>(x, y, z), source<2>(x, y, z));
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y, int z) const
+                -> typename std::invoke_result<const raw_type<StoredLHS>&, int, int, int>::type {
+                return std::as_const(tensor3)(source<0>(x, y, z), source<1>(x, y, z), source<2>(x, y, z));
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y)
+                -> typename std::invoke_result<StoredLHS, int, int>::type {
+                if constexpr (isIdentity) return tensor3(x, y);
+                else return (*this)(x, y % PermuteExpr::length(), y / PermuteExpr::length());
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y) const
+                -> typename std::invoke_result<const raw_type<StoredLHS>&, int, int>::type {
+                if constexpr (isIdentity) return std::as_const(tensor3)(x, y);
+                else return (*this)(x, y % PermuteExpr::length(), y / PermuteExpr::length());
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x)
+                -> typename std::invoke_result<StoredLHS, int>::type {
+                if constexpr (isIdentity) return tensor3(x);
+                else return (*this)(x % PermuteExpr::width(), x / PermuteExpr::width());
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x) const
+                -> typename std::invoke_result<const raw_type<StoredLHS>&, int>::type {
+                if constexpr (isIdentity) return std::as_const(tensor3)(x);
+                else return (*this)(x % PermuteExpr::width(), x / PermuteExpr::width());
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto& underlyingTensor3() noexcept {
+                return tensor3;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& underlyingTensor3() const noexcept {
+                return tensor3;
+            }
+
+        private:
+            StoredLHS tensor3;
+
+            // Figure out which view coordinate feeds the given axis of the underlying expression.
+            template <int axis>
+            static constexpr STEALTH_ALWAYS_INLINE int source(int x, int y, int z) noexcept {
+                if constexpr (axisX == axis) return x;
+                else if constexpr (axisY == axis) return y;
+                else return z;
+            }
+    };
+
+} /* Stealth::Tensor */
@@ -0,0 +1,87 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../core/Tensor3Base.hpp"
+#include "../utils.hpp"
+#include "StridedExpr.hpp"
+#include <algorithm>
+#include <type_traits>
+
+namespace Stealth::Tensor {
+    namespace internal {
+        // Averages are summed in at least an int, so that windows of small integers cannot overflow.
+        template <PoolingMode mode, typename ScalarType>
+        using pool_accumulator = typename std::conditional<mode == PoolingMode::Average and std::is_integral<ScalarType>::value,
+            std::common_type_t<ScalarType, int>, ScalarType>::type;
+
+        template <PoolingMode mode, typename Accumulator>
+        constexpr STEALTH_ALWAYS_INLINE Accumulator pool_combine(Accumulator accumulated, Accumulator value) noexcept {
+            if constexpr (mode == PoolingMode::Min) return std::min(accumulated, value);
+            else if constexpr (mode == PoolingMode::Max) return std::max(accumulated, value);
+            else return accumulated + value;
+        }
+
+        template <PoolingMode mode, int windowSize, typename ScalarType>
+        constexpr STEALTH_ALWAYS_INLINE ScalarType pool_finalize(pool_accumulator<mode, ScalarType> accumulated) noexcept {
+            if constexpr (mode == PoolingMode::Average) {
+                return static_cast<ScalarType>(accumulated / static_cast<pool_accumulator<mode, ScalarType>>(windowSize));
+            } else return accumulated;
+        }
+
+        template <int windowX, int windowY, int windowZ, PoolingMode mode, typename LHS>
+        struct traits<PoolExpr<windowX, windowY, windowZ, mode, LHS>> {
+            static constexpr ExpressionType exprType = ExpressionType::PoolExpr;
+            using ScalarType = typename internal::traits<LHS>::ScalarType;
+            // Partial windows at the edges are dropped.
+            static constexpr int length = internal::traits<LHS>::length / windowY,
+                width = internal::traits<LHS>::width / windowX,
+                height = internal::traits<LHS>::height / windowZ,
+                indexingMode = strided_indexing_mode<width, length, height>();
+            static constexpr long long area = static_cast<long long>(length) * width,
+                size = area * height;
+            using StoredLHS = expr_ref<LHS>;
+            static constexpr bool is_scalar = size == 1;
+            static constexpr bool is_vector = !is_scalar and (width == size or length == size or height == size);
+            static constexpr bool is_matrix = !is_vector and (width == 1 or length == 1 or height == 1);
+        };
+    } /* internal */
+
+    template <int windowX, int windowY, int windowZ, PoolingMode mode, typename LHS>
+    class PoolExpr : public Tensor3Base<PoolExpr<windowX, windowY, windowZ, mode, LHS>> {
+        public:
+            using StoredLHS = typename internal::traits<PoolExpr>::StoredLHS;
+            using ScalarType = typename internal::traits<PoolExpr>::ScalarType;
+
+            constexpr STEALTH_ALWAYS_INLINE PoolExpr(LHS&& otherTensor3) noexcept
+                : tensor3{otherTensor3} {
+                static_assert(windowX > 0 and windowY > 0 and windowZ > 0, "Pooling windows must be positive");
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE ScalarType operator()(int x, int y, int z) const {
+                const int minX = x * windowX, minY = y * windowY, minZ = z * windowZ;
+                using Accumulator = internal::pool_accumulator<mode, ScalarType>;
+                Accumulator accumulated = static_cast<ScalarType>(std::as_const(tensor3)(minX, minY, minZ));
+                for (int k = 0; k < windowZ; ++k) {
+                    for (int j = 0; j < windowY; ++j) {
+                        for (int i = (j == 0 and k == 0) ? 1 : 0; i < windowX; ++i) {
+                            accumulated = internal::pool_combine<mode>(accumulated,
+                                static_cast<Accumulator>(static_cast<ScalarType>(std::as_const(tensor3)(minX + i, minY + j, minZ + k))));
+                        }
+                    }
+                }
+                return internal::pool_finalize<mode, windowX * windowY * windowZ, ScalarType>(accumulated);
+            }
+
+            // The lower dimensional accessors fold the remaining axes into the last one.
+            constexpr STEALTH_ALWAYS_INLINE ScalarType operator()(int x, int y) const {
+                return (*this)(x, y % PoolExpr::length(), y / PoolExpr::length());
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE ScalarType operator()(int x) const {
+                return (*this)(x % PoolExpr::width(), x / PoolExpr::width());
+            }
+
+        private:
+            StoredLHS tensor3;
+    };
+
+} /* Stealth::Tensor */
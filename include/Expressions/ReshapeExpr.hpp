@@ -0,0 +1,80 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../core/Tensor3Base.hpp"
+#include "../utils.hpp"
+
+namespace Stealth::Tensor {
+    namespace internal {
+        template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime, typename LHS>
+        struct traits<ReshapeExpr<widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime, LHS>> {
+            static constexpr ExpressionType exprType = ExpressionType::ReshapeExpr;
+            using ScalarType = typename internal::traits<LHS>::ScalarType;
+            // Dimensions
+            static constexpr int length = lengthAtCompileTime,
+                width = widthAtCompileTime,
+                height = heightAtCompileTime,
+                indexingMode = 1;
+            static constexpr long long area = static_cast<long long>(length) * width,
+                size = area * height;
+            using StoredLHS = expr_ref<LHS>;
+            static constexpr bool is_scalar = size == 1;
+            static constexpr bool is_vector = !is_scalar and (width == size or length == size or height == size);
+            static constexpr bool is_matrix = !is_vector and (width == 1 or length == 1 or height == 1);
+        };
+    } /* internal */
+
+    // Reinterprets size() consecutive elements of a contiguous expression, starting at offset.
+    template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime, typename LHS>
+    class ReshapeExpr : public Tensor3Base<ReshapeExpr<widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime, LHS>> {
+        public:
+            using StoredLHS = typename internal::traits<ReshapeExpr>::StoredLHS;
+
+            constexpr STEALTH_ALWAYS_INLINE ReshapeExpr(LHS&& otherTensor3, int offset = 0) noexcept
+                : tensor3{otherTensor3}, offset{offset} {
+                static_assert(internal::traits<LHS>::indexingMode == 1, "Cannot reshape a non-contiguous expression");
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y, int z)
+                -> typename std::invoke_result<StoredLHS, int>::type {
+                return tensor3(offset + x + y * widthAtCompileTime + z * ReshapeExpr::area());
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y, int z) const
+                -> typename std::invoke_result<const raw_type<StoredLHS>&, int>::type {
+                return std::as_const(tensor3)(offset + x + y * widthAtCompileTime + z * ReshapeExpr::area());
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y)
+                -> typename std::invoke_result<StoredLHS, int>::type {
+                return tensor3(offset + x + y * widthAtCompileTime);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y) const
+                -> typename std::invoke_result<const raw_type<StoredLHS>&, int>::type {
+                return std::as_const(tensor3)(offset + x + y * widthAtCompileTime);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x)
+                -> typename std::invoke_result<StoredLHS, int>::type {
+                return tensor3(offset + x);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x) const
+                -> typename std::invoke_result<const raw_type<StoredLHS>&, int>::type {
+                return std::as_const(tensor3)(offset + x);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto& underlyingTensor3() noexcept {
+                return tensor3;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& underlyingTensor3() const noexcept {
+                return tensor3;
+            }
+
+        private:
+            StoredLHS tensor3;
+            const int offset;
+    };
+
+} /* Stealth::Tensor */
@@ -0,0 +1,126 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../core/Tensor3Base.hpp"
+#include "../utils.hpp"
+#include "ElemWiseBinaryExpr.hpp"
+#include <algorithm>
+#include <type_traits>
+
+namespace Stealth::Tensor {
+    namespace internal {
+        template <typename Cond, typename LHS, typename RHS>
+        struct traits<SelectExpr<Cond, LHS, RHS>> {
+            static constexpr ExpressionType exprType = ExpressionType::SelectExpr;
+            using ScalarType = typename std::common_type<typename internal::traits<LHS>::ScalarType,
+                typename internal::traits<RHS>::ScalarType>::type;
+            // Dimensions - broadcast in the same way as ElemWiseBinaryExpr, but over three operands.
+            static constexpr int length = std::max({internal::traits<Cond>::length, internal::traits<LHS>::length,
+                    internal::traits<RHS>::length}),
+                width = std::max({internal::traits<Cond>::width, internal::traits<LHS>::width,
+                    internal::traits<RHS>::width}),
+                height = std::max({internal::traits<Cond>::height, internal::traits<LHS>::height,
+                    internal::traits<RHS>::height}),
+                indexingMode = std::max({optimal_indexing_mode<Cond, LHS>(), optimal_indexing_mode<Cond, RHS>(),
+                    optimal_indexing_mode<LHS, RHS>()});
+            static constexpr long long area = std::max({internal::traits<Cond>::area, internal::traits<LHS>::area,
+                    internal::traits<RHS>::area}),
+                size = std::max({internal::traits<Cond>::size, internal::traits<LHS>::size,
+                    internal::traits<RHS>::size});
+            using StoredCond = expr_ref<Cond>;
+            using StoredLHS = expr_ref<LHS>;
+            using StoredRHS = expr_ref<RHS>;
+            static constexpr bool is_scalar = size == 1;
+            static constexpr bool is_vector = !is_scalar and (width == size or length == size or height == size);
+            static constexpr bool is_matrix = !is_vector and (width == 1 or length == 1 or height == 1);
+        };
+    } /* internal */
+
+    template <typename Cond, typename LHS, typename RHS>
+    class SelectExpr : public Tensor3Base<SelectExpr<Cond, LHS, RHS>> {
+        // Store either a reference or copy depending on what the operands are.
+        using StoredCond = typename internal::traits<SelectExpr>::StoredCond;
+        using StoredLHS = typename internal::traits<SelectExpr>::StoredLHS;
+        using StoredRHS = typename internal::traits<SelectExpr>::StoredRHS;
+
+        public:
+            using ScalarType = typename internal::traits<SelectExpr>::ScalarType;
+
+            constexpr STEALTH_ALWAYS_INLINE SelectExpr(Cond&& cond, LHS&& lhs, RHS&& rhs) noexcept
+                : cond{std::forward<Cond&&>(cond)}, lhs{std::forward<LHS&&>(lhs)}, rhs{std::forward<RHS&&>(rhs)} {
+                static_assert(assert_compatibility<Cond, LHS>() and assert_compatibility<Cond, RHS>()
+                    and assert_compatibility<LHS, RHS>(), "Cannot perform select on incompatible arguments");
+            }
+
+            // Both sides are always evaluated so that the compiler can emit a blend instead of a branch.
+            constexpr STEALTH_ALWAYS_INLINE ScalarType operator()(int x, int y, int z) const {
+                const ScalarType ifTrue = whenTrue(x, y, z), ifFalse = whenFalse(x, y, z);
+                return condition(x, y, z) ? ifTrue : ifFalse;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE ScalarType operator()(int x, int y) const {
+                const ScalarType ifTrue = whenTrue(x, y), ifFalse = whenFalse(x, y);
+                return condition(x, y) ? ifTrue : ifFalse;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE ScalarType operator()(int x) const {
+                const ScalarType ifTrue = whenTrue(x), ifFalse = whenFalse(x);
+                return condition(x) ? ifTrue : ifFalse;
+            }
+
+            // Broadcasting accessors for each operand, used by evaluators to skip the unused side.
+            constexpr STEALTH_ALWAYS_INLINE bool condition(int x, int y, int z) const {
+                return std::as_const(cond)((cond.width() == 1) ? 0 : x, (cond.length() == 1) ? 0 : y,
+                    (cond.height() == 1) ? 0 : z);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE bool condition(int x, int y) const {
+                return std::as_const(cond)((cond.width() == 1) ? 0 : x, (cond.length() == 1) ? 0 : y);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE bool condition(int x) const {
+                return std::as_const(cond)((cond.width() == 1) ? 0 : x);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE ScalarType whenTrue(int x, int y, int z) const {
+                return std::as_const(lhs)((lhs.width() == 1) ? 0 : x, (lhs.length() == 1) ? 0 : y,
+                    (lhs.height() == 1) ? 0 : z);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE ScalarType whenTrue(int x, int y) const {
+                return std::as_const(lhs)((lhs.width() == 1) ? 0 : x, (lhs.length() == 1) ? 0 : y);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE ScalarType whenTrue(int x) const {
+                return std::as_const(lhs)((lhs.width() == 1) ? 0 : x);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE ScalarType whenFalse(int x, int y, int z) const {
+                return std::as_const(rhs)((rhs.width() == 1) ? 0 : x, (rhs.length() == 1) ? 0 : y,
+                    (rhs.height() == 1) ? 0 : z);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE ScalarType whenFalse(int x, int y) const {
+                return std::as_const(rhs)((rhs.width() == 1) ? 0 : x, (rhs.length() == 1) ? 0 : y);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE ScalarType whenFalse(int x) const {
+                return std::as_const(rhs)((rhs.width() == 1) ? 0 : x);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& condExpr() const noexcept {
+                return cond;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& lhsExpr() const noexcept {
+                return lhs;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& rhsExpr() const noexcept {
+                return rhs;
+            }
+        private:
+            StoredCond cond;
+            StoredLHS lhs;
+            StoredRHS rhs;
+    };
+} /* Stealth::Tensor */
@@ -0,0 +1,101 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../core/Tensor3Base.hpp"
+#include "../utils.hpp"
+
+namespace Stealth::Tensor {
+    namespace {
+        template <int width, int length, int height>
+        constexpr STEALTH_ALWAYS_INLINE auto strided_indexing_mode() noexcept {
+            // Strided views always map back through the underlying 3D accessor, so the only
+            // thing that matters is how many dimensions the view itself spans. Lower modes
+            // would require divisions to recover the coordinates.
+            if constexpr (height == 1 && length == 1) {
+                return 1;
+            } else if constexpr (height == 1) {
+                return 2;
+            } else {
+                return 3;
+            }
+        }
+    }
+
+    namespace internal {
+        template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime,
+            int strideX, int strideY, int strideZ, typename LHS>
+        struct traits<StridedExpr<widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime,
+            strideX, strideY, strideZ, LHS>> {
+            static constexpr ExpressionType exprType = ExpressionType::StridedExpr;
+            using ScalarType = typename internal::traits<LHS>::ScalarType;
+            // Dimensions
+            static constexpr int length = lengthAtCompileTime,
+                width = widthAtCompileTime,
+                height = heightAtCompileTime,
+                indexingMode = strided_indexing_mode<width, length, height>();
+            static constexpr long long area = static_cast<long long>(length) * width,
+                size = area * height;
+            using StoredLHS = expr_ref<LHS>;
+            static constexpr bool is_scalar = size == 1;
+            static constexpr bool is_vector = !is_scalar and (width == size or length == size or height == size);
+            static constexpr bool is_matrix = !is_vector and (width == 1 or length == 1 or height == 1);
+        };
+    } /* internal */
+
+    // Strides may be negative, in which case the view walks backwards from (x, y, z).
+    template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime,
+        int strideX, int strideY, int strideZ, typename LHS>
+    class StridedExpr : public Tensor3Base<StridedExpr<widthAtCompileTime, lengthAtCompileTime,
+        heightAtCompileTime, strideX, strideY, strideZ, LHS>> {
+        public:
+            using StoredLHS = typename internal::traits<StridedExpr>::StoredLHS;
+
+            constexpr STEALTH_ALWAYS_INLINE StridedExpr(LHS&& otherTensor3, int x = 0, int y = 0, int z = 0) noexcept
+                : tensor3{otherTensor3}, minX{x}, minY{y}, minZ{z} {
+                static_assert(strideX != 0 and strideY != 0 and strideZ != 0, "Strides must be non-zero");
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y, int z)
+                -> typename std::invoke_result<StoredLHS, int, int, int>::type {
+                return tensor3(minX + x * strideX, minY + y * strideY, minZ + z * strideZ);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y, int z) const
+                -> typename std::invoke_result<const raw_type<StoredLHS>&, int, int, int>::type {
+                return std::as_const(tensor3)(minX + x * strideX, minY + y * strideY, minZ + z * strideZ);
+            }
+
+            // The lower dimensional accessors fold the remaining axes into the last one.
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y)
+                -> typename std::invoke_result<StoredLHS, int, int, int>::type {
+                return (*this)(x, y % lengthAtCompileTime, y / lengthAtCompileTime);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x, int y) const
+                -> typename std::invoke_result<const raw_type<StoredLHS>&, int, int, int>::type {
+                return (*this)(x, y % lengthAtCompileTime, y / lengthAtCompileTime);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x)
+                -> typename std::invoke_result<StoredLHS, int, int, int>::type {
+                return (*this)(x % widthAtCompileTime, x / widthAtCompileTime);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto operator()(int x) const
+                -> typename std::invoke_result<const raw_type<StoredLHS>&, int, int, int>::type {
+                return (*this)(x % widthAtCompileTime, x / widthAtCompileTime);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto& underlyingTensor3() noexcept {
+                return tensor3;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& underlyingTensor3() const noexcept {
+                return tensor3;
+            }
+
+        private:
+            StoredLHS tensor3;
+            const int minX, minY, minZ;
+    };
+
+} /* Stealth::Tensor */
@@ -1,14 +1,96 @@
 #pragma once
 #include "../Expressions/BlockExpr.hpp"
+#include "../Expressions/StridedExpr.hpp"
+#include "../Expressions/PermuteExpr.hpp"
+#include "../Expressions/ReshapeExpr.hpp"
+#include "../Expressions/PoolExpr.hpp"
+#include "RewriteRules.hpp"
 
 namespace Stealth::Tensor {
+    // A block of a block is collapsed into a single block of the innermost expression.
     template <int width = 1, int length = 1, int height = 1, typename LHS>
     constexpr STEALTH_ALWAYS_INLINE auto block(LHS&& lhs, int minX = 0, int minY = 0, int minZ = 0) noexcept {
-        return BlockExpr<width, length, height, LHS&&>{std::forward<LHS&&>(lhs), minX, minY, minZ};
+        if constexpr (internal::traits<LHS>::exprType == internal::ExpressionType::BlockExpr) {
+            const auto offsets = lhs.offsets();
+            return block<width, length, height>(
+                internal::forward_stored<typename internal::traits<raw_type<LHS>>::StoredLHS, LHS>(lhs.underlyingTensor3()),
+                minX + offsets[0], minY + offsets[1], minZ + offsets[2]);
+        } else {
+            return BlockExpr<width, length, height, LHS&&>{std::forward<LHS&&>(lhs), minX, minY, minZ};
+        }
     }
 
     template <typename LHS>
     constexpr STEALTH_ALWAYS_INLINE auto layer(LHS&& lhs, int layerNum = 0) {
         return block<lhs.width(), lhs.length()>(std::forward<LHS&&>(lhs), 0, 0, layerNum);
     }
+
+    // Unit strides are just a block, which keeps the contiguous indexing paths available.
+    template <int width = 1, int length = 1, int height = 1, int strideX = 1, int strideY = 1, int strideZ = 1,
+        typename LHS>
+    constexpr STEALTH_ALWAYS_INLINE auto strided(LHS&& lhs, int minX = 0, int minY = 0, int minZ = 0) noexcept {
+        if constexpr (strideX == 1 and strideY == 1 and strideZ == 1) {
+            return block<width, length, height>(std::forward<LHS&&>(lhs), minX, minY, minZ);
+        } else {
+            return StridedExpr<width, length, height, strideX, strideY, strideZ, LHS&&>{std::forward<LHS&&>(lhs),
+                minX, minY, minZ};
+        }
+    }
+
+    // Every n-th element along each axis, over the whole expression.
+    template <int strideX = 1, int strideY = 1, int strideZ = 1, typename LHS>
+    constexpr STEALTH_ALWAYS_INLINE auto step(LHS&& lhs) noexcept {
+        static_assert(strideX > 0 and strideY > 0 and strideZ > 0, "Use reverse() to step backwards");
+        constexpr int width = (internal::traits<LHS>::width + strideX - 1) / strideX;
+        constexpr int length = (internal::traits<LHS>::length + strideY - 1) / strideY;
+        constexpr int height = (internal::traits<LHS>::height + strideZ - 1) / strideZ;
+        return strided<width, length, height, strideX, strideY, strideZ>(std::forward<LHS&&>(lhs));
+    }
+
+    template <bool reverseX = true, bool reverseY = false, bool reverseZ = false, typename LHS>
+    constexpr STEALTH_ALWAYS_INLINE auto reverse(LHS&& lhs) noexcept {
+        constexpr int width = internal::traits<LHS>::width,
+            length = internal::traits<LHS>::length,
+            height = internal::traits<LHS>::height;
+        return strided<width, length, height, (reverseX ? -1 : 1), (reverseY ? -1 : 1), (reverseZ ? -1 : 1)>(
+            std::forward<LHS&&>(lhs), (reverseX ? width - 1 : 0), (reverseY ? length - 1 : 0),
+            (reverseZ ? height - 1 : 0));
+    }
+
+    template <int axisX, int axisY, int axisZ = 2, typename LHS>
+    constexpr STEALTH_ALWAYS_INLINE auto permute(LHS&& lhs) noexcept {
+        return PermuteExpr<axisX, axisY, axisZ, LHS&&>{std::forward<LHS&&>(lhs)};
+    }
+
+    // Swap the x and y axes of every layer.
+    template <typename LHS>
+    constexpr STEALTH_ALWAYS_INLINE auto transpose(LHS&& lhs) noexcept {
+        return permute<1, 0, 2>(std::forward<LHS&&>(lhs));
+    }
+
+    // Reinterpret a contiguous expression with new dimensions, starting at a flat offset.
+    template <int width = 1, int length = 1, int height = 1, typename LHS>
+    constexpr STEALTH_ALWAYS_INLINE auto reshape(LHS&& lhs, int offset = 0) noexcept {
+        return ReshapeExpr<width, length, height, LHS&&>{std::forward<LHS&&>(lhs), offset};
+    }
+
+    template <int windowX = 2, int windowY = 2, int windowZ = 1, PoolingMode mode = PoolingMode::Average, typename LHS>
+    constexpr STEALTH_ALWAYS_INLINE auto pool(LHS&& lhs) noexcept {
+        return PoolExpr<windowX, windowY, windowZ, mode, LHS&&>{std::forward<LHS&&>(lhs)};
+    }
+
+    template <int windowX = 2, int windowY = 2, int windowZ = 1, typename LHS>
+    constexpr STEALTH_ALWAYS_INLINE auto avgPool(LHS&& lhs) noexcept {
+        return pool<windowX, windowY, windowZ, PoolingMode::Average>(std::forward<LHS&&>(lhs));
+    }
+
+    template <int windowX = 2, int windowY = 2, int windowZ = 1, typename LHS>
+    constexpr STEALTH_ALWAYS_INLINE auto minPool(LHS&& lhs) noexcept {
+        return pool<windowX, windowY, windowZ, PoolingMode::Min>(std::forward<LHS&&>(lhs));
+    }
+
+    template <int windowX = 2, int windowY = 2, int windowZ = 1, typename LHS>
+    constexpr STEALTH_ALWAYS_INLINE auto maxPool(LHS&& lhs) noexcept {
+        return pool<windowX, windowY, windowZ, PoolingMode::Max>(std::forward<LHS&&>(lhs));
+    }
 } /* Stealth::Tensor */
@@ -0,0 +1,110 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../Executors/Executor.hpp"
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <vector>
+
+namespace Stealth::Tensor {
+    // Flat indices of matching elements, along with the value of another expression at each of them. Indices are
+    // int, unless the expression has more elements than int can count.
+    template <typename ScalarType, typename IndexType = int>
+    struct Compaction {
+        std::vector<IndexType> indices;
+        std::vector<ScalarType> values;
+    };
+
+    namespace internal {
+        // Evaluates the predicate once per element, collecting the flat indices of matches for each chunk of rows
+        // in parallel. The chunk counts are then scanned, resize(total) is called once, and finally
+        // write(chunkIndices, offset) is called in parallel for every chunk with the output position of its first match.
+        template <typename Predicate, typename Resize, typename Write>
+        void compact(const Predicate& predicate, const Resize& resize, const Write& write) {
+            using Index = index_type<traits<Predicate>::size>;
+            constexpr int width = traits<Predicate>::width,
+                length = traits<Predicate>::length,
+                numRows = length * traits<Predicate>::height;
+            constexpr int rowsPerChunk = std::max(1, kPARALLEL_GRAIN_SIZE / width);
+            constexpr int numChunks = (numRows + rowsPerChunk - 1) / rowsPerChunk;
+            std::vector<std::vector<Index>> matches(numChunks);
+            parallel_for(0, numChunks, 1, [&predicate, &matches](int begin, int end) {
+                for (int chunk = begin; chunk < end; ++chunk) {
+                    const int rowEnd = std::min(int{numRows}, (chunk + 1) * rowsPerChunk);
+                    for (int row = chunk * rowsPerChunk; row < rowEnd; ++row) {
+                        const int y = row % length, z = row / length;
+                        const Index rowOffset = Index{row} * width;
+                        for (int x = 0; x < width; ++x) {
+                            if (static_cast<bool>(predicate(x, y, z))) matches[chunk].push_back(x + rowOffset);
+                        }
+                    }
+                }
+            });
+            std::vector<Index> offsets(numChunks + 1, 0);
+            for (int chunk = 0; chunk < numChunks; ++chunk) {
+                offsets[chunk + 1] = offsets[chunk] + static_cast<Index>(matches[chunk].size());
+            }
+            resize(offsets[numChunks]);
+            parallel_for(0, numChunks, 1, [&matches, &offsets, &write](int begin, int end) {
+                for (int chunk = begin; chunk < end; ++chunk) write(matches[chunk], offsets[chunk]);
+            });
+        }
+    } /* internal */
+
+    // Flat indices of every element where predicate is true, in order, e.g. nonzero(hp < 10 and owner == player).
+    template <typename Predicate>
+    auto nonzero(const Predicate& predicate) {
+        using Index = internal::index_type<internal::traits<Predicate>::size>;
+        std::vector<Index> indices;
+        internal::compact(predicate, [&indices](Index size) { indices.resize(size); },
+            [&indices](const std::vector<Index>& chunkIndices, Index offset) {
+                std::copy(chunkIndices.begin(), chunkIndices.end(), indices.data() + offset);
+            });
+        return indices;
+    }
+
+    // Coordinates of every element where predicate is true, in order.
+    template <typename Predicate>
+    std::vector<std::array<int, 3>> find(const Predicate& predicate) {
+        using Index = internal::index_type<internal::traits<Predicate>::size>;
+        constexpr int width = internal::traits<Predicate>::width, length = internal::traits<Predicate>::length;
+        std::vector<std::array<int, 3>> coordinates;
+        internal::compact(predicate, [&coordinates](Index size) { coordinates.resize(size); },
+            [&coordinates](const std::vector<Index>& chunkIndices, Index offset) {
+                for (std::size_t i = 0; i < chunkIndices.size(); ++i) {
+                    const Index index = chunkIndices[i];
+                    coordinates[offset + i] = {static_cast<int>(index % width), static_cast<int>(index / width % length),
+                        static_cast<int>(index / (Index{width} * length))};
+                }
+            });
+        return coordinates;
+    }
+
+    // Like nonzero, but also gathers values at every match, e.g. compact(hp < 10, position).
+    template <typename Predicate, typename Values>
+    auto compact(const Predicate& predicate, const Values& values) {
+        static_assert(internal::traits<Predicate>::width == internal::traits<Values>::width
+            and internal::traits<Predicate>::length == internal::traits<Values>::length
+            and internal::traits<Predicate>::height == internal::traits<Values>::height,
+            "Cannot compact values of a different shape to the predicate");
+        // Chunks are written concurrently, which std::vector<bool> cannot support.
+        static_assert(not std::is_same<typename internal::traits<Values>::ScalarType, bool>::value,
+            "Cannot compact boolean values");
+        using Index = internal::index_type<internal::traits<Predicate>::size>;
+        constexpr int width = internal::traits<Predicate>::width, length = internal::traits<Predicate>::length;
+        Compaction<typename internal::traits<Values>::ScalarType, Index> result;
+        internal::compact(predicate, [&result](Index size) {
+                result.indices.resize(size);
+                result.values.resize(size);
+            },
+            [&result, &values](const std::vector<Index>& chunkIndices, Index offset) {
+                for (std::size_t i = 0; i < chunkIndices.size(); ++i) {
+                    const Index index = chunkIndices[i];
+                    result.indices[offset + i] = index;
+                    result.values[offset + i] = values(static_cast<int>(index % width), static_cast<int>(index / width % length),
+                        static_cast<int>(index / (Index{width} * length)));
+                }
+            });
+        return result;
+    }
+} /* Stealth::Tensor */
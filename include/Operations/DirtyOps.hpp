@@ -0,0 +1,138 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../core/TrackedTensor3.hpp"
+#include "../utils.hpp"
+#include "../Executors/Executor.hpp"
+#include <algorithm>
+
+namespace Stealth::Tensor {
+    // Range of offsets, relative to an output element, at which an expression reads
+    // from TrackedTensor3s. An empty footprint means no tracked inputs are read at all.
+    struct Footprint {
+        // Offsets beyond this are treated as reading the entire axis.
+        static constexpr int kUNBOUNDED = 1 << 24;
+
+        bool empty = true;
+        int minX = 0, minY = 0, minZ = 0, maxX = 0, maxY = 0, maxZ = 0;
+
+        static constexpr STEALTH_ALWAYS_INLINE Footprint point() noexcept {
+            return Footprint{false};
+        }
+
+        static constexpr STEALTH_ALWAYS_INLINE Footprint unbounded() noexcept {
+            return Footprint{false, -kUNBOUNDED, -kUNBOUNDED, -kUNBOUNDED, kUNBOUNDED, kUNBOUNDED, kUNBOUNDED};
+        }
+
+        constexpr STEALTH_ALWAYS_INLINE Footprint merge(const Footprint& other) const noexcept {
+            if (empty) return other;
+            if (other.empty) return *this;
+            return Footprint{false, std::min(minX, other.minX), std::min(minY, other.minY), std::min(minZ, other.minZ),
+                std::max(maxX, other.maxX), std::max(maxY, other.maxY), std::max(maxZ, other.maxZ)};
+        }
+
+        constexpr STEALTH_ALWAYS_INLINE Footprint shift(int x, int y, int z) const noexcept {
+            if (empty) return *this;
+            return Footprint{false, minX + x, minY + y, minZ + z, maxX + x, maxY + y, maxZ + z};
+        }
+    };
+
+    namespace internal {
+        // Operands that are broadcast read the same element for every output along that axis.
+        template <typename Result, typename Operand>
+        constexpr STEALTH_ALWAYS_INLINE Footprint broadcast_footprint(Footprint footprint) noexcept {
+            if (footprint.empty) return footprint;
+            if (traits<Operand>::width == 1 and traits<Result>::width != 1) {
+                footprint.minX = -Footprint::kUNBOUNDED; footprint.maxX = Footprint::kUNBOUNDED;
+            }
+            if (traits<Operand>::length == 1 and traits<Result>::length != 1) {
+                footprint.minY = -Footprint::kUNBOUNDED; footprint.maxY = Footprint::kUNBOUNDED;
+            }
+            if (traits<Operand>::height == 1 and traits<Result>::height != 1) {
+                footprint.minZ = -Footprint::kUNBOUNDED; footprint.maxZ = Footprint::kUNBOUNDED;
+            }
+            return footprint;
+        }
+    } /* internal */
+
+    // Walks the expression tree. Expressions that are not understood are conservatively unbounded.
+    template <typename Expr>
+    constexpr Footprint footprint(const Expr& expr) noexcept {
+        using RawExpr = raw_type<Expr>;
+        constexpr internal::ExpressionType exprType = internal::traits<RawExpr>::exprType;
+        if constexpr (exprType == internal::ExpressionType::TrackedTensor3) {
+            return Footprint::point();
+        } else if constexpr (exprType == internal::ExpressionType::Tensor3) {
+            return Footprint{};
+        } else if constexpr (exprType == internal::ExpressionType::BlockExpr) {
+            const auto offsets = expr.offsets();
+            return footprint(expr.underlyingTensor3()).shift(offsets[0], offsets[1], offsets[2]);
+        } else if constexpr (exprType == internal::ExpressionType::ElemWiseUnaryExpr) {
+            return footprint(expr.lhsExpr());
+        } else if constexpr (exprType == internal::ExpressionType::ElemWiseBinaryExpr) {
+            using LHS = raw_type<decltype(expr.lhsExpr())>;
+            using RHS = raw_type<decltype(expr.rhsExpr())>;
+            return internal::broadcast_footprint<RawExpr, LHS>(footprint(expr.lhsExpr()))
+                .merge(internal::broadcast_footprint<RawExpr, RHS>(footprint(expr.rhsExpr())));
+        } else if constexpr (exprType == internal::ExpressionType::SelectExpr) {
+            using Cond = raw_type<decltype(expr.condExpr())>;
+            using LHS = raw_type<decltype(expr.lhsExpr())>;
+            using RHS = raw_type<decltype(expr.rhsExpr())>;
+            return internal::broadcast_footprint<RawExpr, Cond>(footprint(expr.condExpr()))
+                .merge(internal::broadcast_footprint<RawExpr, LHS>(footprint(expr.lhsExpr())))
+                .merge(internal::broadcast_footprint<RawExpr, RHS>(footprint(expr.rhsExpr())));
+        } else {
+            return Footprint::unbounded();
+        }
+    }
+
+    // Output elements that may change when the given input region does.
+    template <typename Expr>
+    constexpr Region affected_region(const Expr& expr, const Region& dirty) noexcept {
+        const Footprint reads = footprint(expr);
+        if (reads.empty or dirty.empty()) return Region{};
+        // Output o reads o + offset, so it is affected if o + offset lands in the dirty region.
+        return Region{
+            std::max(0, dirty.minX - reads.maxX), std::max(0, dirty.minY - reads.maxY),
+            std::max(0, dirty.minZ - reads.maxZ),
+            std::min<int>(internal::traits<Expr>::width, dirty.maxX - reads.minX),
+            std::min<int>(internal::traits<Expr>::length, dirty.maxY - reads.minY),
+            std::min<int>(internal::traits<Expr>::height, dirty.maxZ - reads.minZ)
+        };
+    }
+
+    // Re-evaluates expr into dest only where a change in the dirty region could have had an effect.
+    template <typename Dest, typename Expr>
+    constexpr void evalDirty(Dest& dest, const Expr& expr, const Region& dirty) {
+        static_assert(internal::traits<Dest>::size == internal::traits<Expr>::size,
+            "Cannot evaluate into incompatible Tensor3");
+        const Region region = affected_region(expr, dirty);
+        if (region.empty()) return;
+        auto evaluate = [&region, &expr](auto& target) {
+            const int regionLength = region.maxY - region.minY;
+            internal::parallel_for(0, regionLength * (region.maxZ - region.minZ), internal::row_grain(region.maxX - region.minX),
+                [&](int begin, int end) {
+                    for (int row = begin; row < end; ++row) {
+                        const int y = region.minY + row % regionLength;
+                        const int z = region.minZ + row / regionLength;
+                        #pragma omp simd
+                        for (int x = region.minX; x < region.maxX; ++x) {
+                            target(x, y, z) = expr(x, y, z);
+                        }
+                    }
+                });
+        };
+        if constexpr (internal::traits<Dest>::exprType == internal::ExpressionType::TrackedTensor3) {
+            // Propagate dirtiness so that further dependent maps can be updated in turn.
+            dest.markDirty(region);
+            evaluate(dest.untracked());
+        } else {
+            evaluate(dest);
+        }
+    }
+
+    // Uses the dirty region recorded by a TrackedTensor3 that expr reads from.
+    template <typename Dest, typename Expr, typename Tracked>
+    constexpr STEALTH_ALWAYS_INLINE void evalDirty(Dest& dest, const Expr& expr, const Tracked& source) {
+        evalDirty(dest, expr, source.dirtyRegion());
+    }
+} /* Stealth::Tensor */
@@ -0,0 +1,167 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../core/Tensor3.hpp"
+#include "../Executors/Executor.hpp"
+#include "../utils.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Stealth::Tensor {
+    enum class Metric {
+        Manhattan,
+        Chebyshev,
+        Euclidean,
+        // Euclidean distance without the final square root, which stays exact in integer tensors.
+        SquaredEuclidean
+    };
+
+    namespace internal {
+        using DistanceType = std::int64_t;
+        // Stands in for an infinite separator between two parabolas (or cones) that never cross.
+        constexpr DistanceType kDISTANCE_UNBOUNDED = std::numeric_limits<DistanceType>::max() / 4;
+
+        constexpr STEALTH_ALWAYS_INLINE DistanceType floor_div(DistanceType numerator, DistanceType denominator) noexcept {
+            const DistanceType quotient = numerator / denominator;
+            return quotient - ((numerator % denominator != 0) and ((numerator < 0) != (denominator < 0)));
+        }
+
+        // Distance from x to the nearest feature at i, given that i is partialCost away along the previous axes.
+        // Euclidean costs are kept squared throughout.
+        template <Metric metric>
+        constexpr STEALTH_ALWAYS_INLINE DistanceType combine(DistanceType x, DistanceType i, DistanceType partialCost) noexcept {
+            if constexpr (metric == Metric::Manhattan) return std::abs(x - i) + partialCost;
+            else if constexpr (metric == Metric::Chebyshev) return std::max(std::abs(x - i), partialCost);
+            else return (x - i) * (x - i) + partialCost;
+        }
+
+        // First position from which u is at least as close as i (for i < u). See Meijster, Roerdink and Hesselink,
+        // "A General Algorithm for Computing Distance Transforms in Linear Time".
+        template <Metric metric>
+        constexpr STEALTH_ALWAYS_INLINE DistanceType separator(DistanceType i, DistanceType u, DistanceType gi, DistanceType gu) noexcept {
+            if constexpr (metric == Metric::Manhattan) {
+                if (gu >= gi + u - i) return kDISTANCE_UNBOUNDED;
+                if (gi > gu + u - i) return -kDISTANCE_UNBOUNDED;
+                return floor_div(gu - gi + u + i, 2);
+            } else if constexpr (metric == Metric::Chebyshev) {
+                if (gi <= gu) return std::max(i + gu, floor_div(i + u, 2));
+                return std::min(u - gi, floor_div(i + u, 2));
+            } else {
+                return floor_div(u * u - i * i + gu - gi, 2 * (u - i));
+            }
+        }
+
+        // Lower envelope of the distance functions rooted at every position of a line, in a single forward and
+        // backward sweep. The scratch buffers must hold at least as many elements as the line.
+        template <Metric metric>
+        inline void distance_envelope(DistanceType* line, int size, int* roots, DistanceType* starts, DistanceType* costs) {
+            std::copy(line, line + size, costs);
+            int top = 0;
+            roots[0] = 0;
+            starts[0] = 0;
+            for (int u = 1; u < size; ++u) {
+                while (top >= 0 and combine<metric>(starts[top], roots[top], costs[roots[top]])
+                    > combine<metric>(starts[top], u, costs[u])) {
+                    --top;
+                }
+                if (top < 0) {
+                    top = 0;
+                    roots[0] = u;
+                } else {
+                    const DistanceType start = 1 + separator<metric>(roots[top], u, costs[roots[top]], costs[u]);
+                    if (start < size) {
+                        ++top;
+                        roots[top] = u;
+                        starts[top] = start;
+                    }
+                }
+            }
+            for (int u = size - 1; u >= 0; --u) {
+                line[u] = combine<metric>(u, roots[top], costs[roots[top]]);
+                if (u == starts[top]) --top;
+            }
+        }
+
+        // Runs the envelope along y (axis 1) or z (axis 2) for every line of the cost tensor.
+        template <int axis, Metric metric, typename Costs>
+        void distance_pass(Costs& costs) {
+            constexpr int width = traits<Costs>::width, length = traits<Costs>::length, height = traits<Costs>::height;
+            constexpr int lineLength = (axis == 1) ? length : height;
+            constexpr int otherLength = (axis == 1) ? height : length;
+            parallel_for(0, width * otherLength, row_grain(lineLength), [&costs](int begin, int end) {
+                std::vector<DistanceType> line(lineLength), starts(lineLength), scratch(lineLength);
+                std::vector<int> roots(lineLength);
+                for (int index = begin; index < end; ++index) {
+                    const int x = index % width, other = index / width;
+                    for (int i = 0; i < lineLength; ++i) {
+                        line[i] = (axis == 1) ? costs(x, i, other) : costs(x, other, i);
+                    }
+                    distance_envelope<metric>(line.data(), lineLength, roots.data(), starts.data(), scratch.data());
+                    for (int i = 0; i < lineLength; ++i) {
+                        if constexpr (axis == 1) costs(x, i, other) = line[i];
+                        else costs(x, other, i) = line[i];
+                    }
+                }
+            });
+        }
+    } /* internal */
+
+    // Writes the distance from every element to the nearest element where features is true, e.g.
+    //     distanceTransform<Metric::Manhattan>(distances, map == WALL);
+    // Each axis is handled separately in linear time, first along rows and then along columns, with lines spread
+    // across threads. Distances are measured within each layer unless acrossLayers is set, in which case they
+    // span the whole volume. Elements with no feature in reach are set to infinity, or the largest value of dest.
+    template <Metric metric = Metric::Euclidean, bool acrossLayers = false, typename Dest, typename Features>
+    void distanceTransform(Dest&& dest, const Features& features) {
+        using ScalarType = typename internal::traits<Dest>::ScalarType;
+        using internal::DistanceType;
+        constexpr int width = internal::traits<Dest>::width,
+            length = internal::traits<Dest>::length,
+            height = internal::traits<Dest>::height;
+        static_assert(width == internal::traits<Features>::width and length == internal::traits<Features>::length
+            and height == internal::traits<Features>::height, "Cannot compute distance transform into incompatible Tensor3");
+        constexpr bool squared = metric == Metric::Euclidean or metric == Metric::SquaredEuclidean;
+        constexpr Metric envelopeMetric = squared ? Metric::SquaredEuclidean : metric;
+        // Larger than any distance between two elements, yet small enough that squaring it cannot overflow.
+        constexpr DistanceType unreachable = width + length + height;
+        constexpr DistanceType unreachableCost = squared ? unreachable * unreachable : unreachable;
+
+        // Distance along each row, from a forward and a backward sweep.
+        Tensor3<DistanceType, width, length, height> costs{kUNINITIALIZED};
+        internal::parallel_for(0, length * height, internal::row_grain(width), [&costs, &features](int begin, int end) {
+            for (int row = begin; row < end; ++row) {
+                const int y = row % length, z = row / length;
+                DistanceType distance = unreachable;
+                for (int x = 0; x < width; ++x) {
+                    distance = static_cast<bool>(features(x, y, z)) ? 0 : std::min(distance + 1, DistanceType{unreachable});
+                    costs(x, y, z) = distance;
+                }
+                distance = unreachable;
+                for (int x = width - 1; x >= 0; --x) {
+                    distance = (costs(x, y, z) == 0) ? 0 : std::min(distance + 1, DistanceType{unreachable});
+                    const DistanceType nearest = std::min(costs(x, y, z), distance);
+                    costs(x, y, z) = squared ? nearest * nearest : nearest;
+                }
+            }
+        });
+        if constexpr (length > 1) internal::distance_pass<1, envelopeMetric>(costs);
+        if constexpr (acrossLayers and height > 1) internal::distance_pass<2, envelopeMetric>(costs);
+
+        constexpr ScalarType farthest = std::numeric_limits<ScalarType>::has_infinity
+            ? std::numeric_limits<ScalarType>::infinity() : std::numeric_limits<ScalarType>::max();
+        internal::parallel_for(0, length * height, internal::row_grain(width), [&dest, &costs, farthest](int begin, int end) {
+            for (int row = begin; row < end; ++row) {
+                const int y = row % length, z = row / length;
+                #pragma omp simd
+                for (int x = 0; x < width; ++x) {
+                    const DistanceType cost = costs(x, y, z);
+                    if (cost >= unreachableCost) dest(x, y, z) = farthest;
+                    else if constexpr (metric == Metric::Euclidean) dest(x, y, z) = static_cast<ScalarType>(std::sqrt(cost));
+                    else dest(x, y, z) = static_cast<ScalarType>(cost);
+                }
+            }
+        });
+    }
+} /* Stealth::Tensor */
@@ -2,6 +2,7 @@
 #include "../Expressions/ElemWiseBinaryExpr.hpp"
 #include "../Functors/BinaryFunctors.hpp"
 #include "../core/ForwardDeclarations.hpp"
+#include "RewriteRules.hpp"
 
 namespace Stealth::Tensor {
     // Helper to construct ElemWiseBinaryExpr expressions.
@@ -13,18 +14,34 @@ namespace Stealth::Tensor {
         return ElemWiseBinaryExpr<LHS&&, BinaryOperation&&, RHS&&>{std::forward<LHS&&>(lhs), std::forward<BinaryOperation&&>(op), std::forward<RHS&&>(rhs)};
     }
 
-    template <typename LHS, typename RHS>
+    namespace internal {
+        // Rebuilds (x op c1) with a new constant in place of c1.
+        template <typename LHS, typename ConstantType>
+        constexpr STEALTH_ALWAYS_INLINE auto replace_constant(LHS&& lhs, ConstantType constant) noexcept {
+            using Inner = raw_type<LHS>;
+            using Op = raw_type<decltype(lhs.operation())>;
+            return apply(Op{}, forward_stored<typename traits<Inner>::StoredLHS, LHS>(lhs.lhsExpr()), constant);
+        }
+    } /* internal */
+
+    template <typename LHS, typename RHS, internal::enable_if_expression<LHS, RHS> = 0>
     constexpr STEALTH_ALWAYS_INLINE auto operator+(LHS&& lhs, RHS&& rhs) noexcept {
-        return apply(
+        // (x + c1) + c2 becomes x + (c1 + c2).
+        if constexpr (internal::can_fold_constants<internal::functors::add, LHS, RHS>()) {
+            return internal::replace_constant(std::forward<LHS&&>(lhs), raw_type<RHS>(lhs.rhsExpr()(0) + rhs));
+        } else return apply(
             internal::functors::add<scalar_element<LHS>, scalar_element<RHS>>{},
             std::forward<LHS&&>(lhs),
             std::forward<RHS&&>(rhs)
         );
     }
 
-    template <typename LHS, typename RHS>
+    template <typename LHS, typename RHS, internal::enable_if_expression<LHS, RHS> = 0>
     constexpr STEALTH_ALWAYS_INLINE auto operator-(LHS&& lhs, RHS&& rhs) noexcept {
-        return apply(
+        // (x - c1) - c2 becomes x - (c1 + c2).
+        if constexpr (internal::can_fold_constants<internal::functors::subtract, LHS, RHS>()) {
+            return internal::replace_constant(std::forward<LHS&&>(lhs), raw_type<RHS>(lhs.rhsExpr()(0) + rhs));
+        } else return apply(
             internal::functors::subtract<scalar_element<LHS>, scalar_element<RHS>>{},
             std::forward<LHS&&>(lhs),
             std::forward<RHS&&>(rhs)
@@ -33,14 +50,17 @@ namespace Stealth::Tensor {
 
     template <typename LHS, typename RHS>
     constexpr STEALTH_ALWAYS_INLINE auto hadamard(LHS&& lhs, RHS&& rhs) noexcept {
-        return apply(
+        // (x * c1) * c2 becomes x * (c1 * c2).
+        if constexpr (internal::can_fold_constants<internal::functors::multiply, LHS, RHS>()) {
+            return internal::replace_constant(std::forward<LHS&&>(lhs), raw_type<RHS>(lhs.rhsExpr()(0) * rhs));
+        } else return apply(
             internal::functors::multiply<scalar_element<LHS>, scalar_element<RHS>>{},
             std::forward<LHS&&>(lhs),
             std::forward<RHS&&>(rhs)
         );
     }
 
-    template <typename LHS, typename RHS>
+    template <typename LHS, typename RHS, internal::enable_if_expression<LHS, RHS> = 0>
     constexpr STEALTH_ALWAYS_INLINE auto operator/(LHS&& lhs, RHS&& rhs) noexcept {
         return apply(
             internal::functors::divide<scalar_element<LHS>, scalar_element<RHS>>{},
@@ -49,7 +69,7 @@ namespace Stealth::Tensor {
         );
     }
 
-    template <typename LHS, typename RHS>
+    template <typename LHS, typename RHS, internal::enable_if_expression<LHS, RHS> = 0>
     constexpr STEALTH_ALWAYS_INLINE auto operator==(LHS&& lhs, RHS&& rhs) noexcept {
         return apply(
             internal::functors::eq<scalar_element<LHS>, scalar_element<RHS>>{},
@@ -58,7 +78,7 @@ namespace Stealth::Tensor {
         );
     }
 
-    template <typename LHS, typename RHS>
+    template <typename LHS, typename RHS, internal::enable_if_expression<LHS, RHS> = 0>
     constexpr STEALTH_ALWAYS_INLINE auto operator!=(LHS&& lhs, RHS&& rhs) noexcept {
         return apply(
             internal::functors::neq<scalar_element<LHS>, scalar_element<RHS>>{},
@@ -67,7 +87,7 @@ namespace Stealth::Tensor {
         );
     }
 
-    template <typename LHS, typename RHS>
+    template <typename LHS, typename RHS, internal::enable_if_expression<LHS, RHS> = 0>
     constexpr STEALTH_ALWAYS_INLINE auto operator<(LHS&& lhs, RHS&& rhs) noexcept {
         return apply(
             internal::functors::less<scalar_element<LHS>, scalar_element<RHS>>{},
@@ -76,7 +96,7 @@ namespace Stealth::Tensor {
         );
     }
 
-    template <typename LHS, typename RHS>
+    template <typename LHS, typename RHS, internal::enable_if_expression<LHS, RHS> = 0>
     constexpr STEALTH_ALWAYS_INLINE auto operator<=(LHS&& lhs, RHS&& rhs) noexcept {
         return apply(
             internal::functors::lessEq<scalar_element<LHS>, scalar_element<RHS>>{},
@@ -85,7 +105,7 @@ namespace Stealth::Tensor {
         );
     }
 
-    template <typename LHS, typename RHS>
+    template <typename LHS, typename RHS, internal::enable_if_expression<LHS, RHS> = 0>
     constexpr STEALTH_ALWAYS_INLINE auto operator>(LHS&& lhs, RHS&& rhs) noexcept {
         return apply(
             internal::functors::greater<scalar_element<LHS>, scalar_element<RHS>>{},
@@ -94,7 +114,7 @@ namespace Stealth::Tensor {
         );
     }
 
-    template <typename LHS, typename RHS>
+    template <typename LHS, typename RHS, internal::enable_if_expression<LHS, RHS> = 0>
     constexpr STEALTH_ALWAYS_INLINE auto operator>=(LHS&& lhs, RHS&& rhs) noexcept {
         return apply(
             internal::functors::greaterEq<scalar_element<LHS>, scalar_element<RHS>>{},
@@ -103,7 +123,7 @@ namespace Stealth::Tensor {
         );
     }
 
-    template <typename LHS, typename RHS>
+    template <typename LHS, typename RHS, internal::enable_if_expression<LHS, RHS> = 0>
     constexpr STEALTH_ALWAYS_INLINE auto operator&&(LHS&& lhs, RHS&& rhs) noexcept {
         return apply(
             internal::functors::andOp<scalar_element<LHS>, scalar_element<RHS>>{},
@@ -112,7 +132,7 @@ namespace Stealth::Tensor {
         );
     }
 
-    template <typename LHS, typename RHS>
+    template <typename LHS, typename RHS, internal::enable_if_expression<LHS, RHS> = 0>
     constexpr STEALTH_ALWAYS_INLINE auto operator||(LHS&& lhs, RHS&& rhs) noexcept {
         return apply(
             internal::functors::orOp<scalar_element<LHS>, scalar_element<RHS>>{},
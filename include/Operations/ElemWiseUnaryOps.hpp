@@ -1,6 +1,7 @@
 #pragma once
 #include "../Expressions/ElemWiseUnaryExpr.hpp"
 #include "../Functors/UnaryFunctors.hpp"
+#include "RewriteRules.hpp"
 
 namespace Stealth::Tensor {
     // Helper to construct ElemWiseUnaryExpr expressions.
@@ -9,9 +10,12 @@ namespace Stealth::Tensor {
         return ElemWiseUnaryExpr<UnaryOperation&&, LHS&&>{std::forward<UnaryOperation&&>(op), std::forward<LHS&&>(lhs)};
     }
 
-    template <typename LHS>
-    constexpr STEALTH_ALWAYS_INLINE auto operator!(LHS&& lhs) noexcept {
-        return apply(
+    template <typename LHS, internal::enable_if_expression<LHS> = 0>
+    constexpr STEALTH_ALWAYS_INLINE decltype(auto) operator!(LHS&& lhs) noexcept {
+        // !!x is just x when x is already boolean.
+        if constexpr (internal::is_double_negation<raw_type<LHS>>::value) {
+            return internal::forward_stored<typename internal::traits<raw_type<LHS>>::StoredLHS, LHS>(lhs.lhsExpr());
+        } else return apply(
             internal::functors::notOp<scalar_element<LHS>>{},
             std::forward<LHS&&>(lhs)
         );
@@ -0,0 +1,100 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../utils.hpp"
+#include "../Executors/CpuDispatch.hpp"
+#include "../Executors/Executor.hpp"
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+namespace Stealth::Tensor {
+    // A deferred dest = expr, to be evaluated as part of fuse().
+    template <typename Dest, typename Expr>
+    struct Assignment {
+        Dest& dest;
+        expr_ref<Expr> expr;
+    };
+
+    template <typename Dest, typename Expr>
+    constexpr STEALTH_ALWAYS_INLINE auto assign(Dest& dest, Expr&& expr) noexcept {
+        return Assignment<Dest, Expr&&>{dest, std::forward<Expr&&>(expr)};
+    }
+
+    namespace internal {
+        template <typename T> struct assignment_traits;
+
+        template <typename Dest, typename Expr>
+        struct assignment_traits<Assignment<Dest, Expr>> {
+            using DestType = Dest;
+            static constexpr int width = traits<Dest>::width,
+                length = traits<Dest>::length,
+                height = traits<Dest>::height;
+            static constexpr bool shapesMatch = traits<Expr>::width == width and traits<Expr>::length == length
+                and traits<Expr>::height == height;
+            static constexpr int indexingMode = std::max(traits<Dest>::indexingMode, traits<Expr>::indexingMode);
+        };
+
+        // Whether every destination and expression has the first destination's shape. Every target is indexed
+        // with the first destination's dimensions, so matching sizes alone are not enough.
+        template <typename First, typename... Assignments>
+        constexpr bool fusable_shapes = ((assignment_traits<Assignments>::shapesMatch
+            and assignment_traits<Assignments>::width == assignment_traits<First>::width
+            and assignment_traits<Assignments>::length == assignment_traits<First>::length
+            and assignment_traits<Assignments>::height == assignment_traits<First>::height) and ...
+            and assignment_traits<First>::shapesMatch);
+
+        // Every expression is evaluated before anything is stored, so that loads of shared
+        // inputs can be reused across outputs instead of being repeated after each store.
+        template <typename Targets, std::size_t... I, typename... Indices>
+        constexpr STEALTH_ALWAYS_INLINE void fused_step(Targets& targets, std::index_sequence<I...>, Indices... indices) {
+            const auto values = std::make_tuple(
+                static_cast<typename traits<decltype(std::get<I>(targets).dest)>::ScalarType>(
+                    std::as_const(std::get<I>(targets).expr)(indices...))...);
+            ((std::get<I>(targets).dest(indices...) = std::get<I>(values)), ...);
+        }
+    } /* internal */
+
+    // Evaluates several assignments in a single parallel pass, e.g.
+    //     fuse(assign(a, x + y), assign(b, x - y), assign(c, max(x, y)));
+    // All destinations must have the same shape.
+    template <typename... Assignments>
+    constexpr void fuse(Assignments&&... assignments) {
+        using First = typename internal::assignment_traits<raw_type<
+            std::tuple_element_t<0, std::tuple<Assignments...>>>>::DestType;
+        static_assert(internal::fusable_shapes<raw_type<Assignments>...>,
+            "Cannot fuse assignments to or from Tensor3s of different shapes");
+        constexpr int indexingModeToUse = std::max({internal::assignment_traits<raw_type<Assignments>>::indexingMode...});
+        auto targets = std::forward_as_tuple(assignments...);
+        constexpr auto sequence = std::index_sequence_for<Assignments...>{};
+        constexpr int width = internal::traits<First>::width,
+            length = internal::traits<First>::length,
+            height = internal::traits<First>::height;
+
+        if constexpr (indexingModeToUse == 1) {
+            internal::parallel_for_dispatch(0, width * length * height, internal::kPARALLEL_GRAIN_SIZE, [&targets, sequence](int begin, int end) {
+                #pragma omp simd
+                for (int i = begin; i < end; ++i) {
+                    internal::fused_step(targets, sequence, i);
+                }
+            });
+        } else if constexpr (indexingModeToUse == 2) {
+            internal::parallel_for_dispatch(0, length * height, internal::row_grain(width), [&targets, sequence](int begin, int end) {
+                for (int j = begin; j < end; ++j) {
+                    #pragma omp simd
+                    for (int i = 0; i < width; ++i) {
+                        internal::fused_step(targets, sequence, i, j);
+                    }
+                }
+            });
+        } else {
+            internal::parallel_for_dispatch(0, length * height, internal::row_grain(width), [&targets, sequence](int begin, int end) {
+                for (int row = begin; row < end; ++row) {
+                    #pragma omp simd
+                    for (int i = 0; i < width; ++i) {
+                        internal::fused_step(targets, sequence, i, row % length, row / length);
+                    }
+                }
+            });
+        }
+    }
+} /* Stealth::Tensor */
@@ -0,0 +1,66 @@
+#pragma once
+#include "../Expressions/GatherExpr.hpp"
+#include "../core/ForwardDeclarations.hpp"
+#include "../Executors/Executor.hpp"
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace Stealth::Tensor {
+    template <typename Table, typename Indices>
+    constexpr STEALTH_ALWAYS_INLINE auto gather(Table&& table, Indices&& indices) noexcept {
+        return GatherExpr<Table&&, Indices&&>{std::forward<Table&&>(table), std::forward<Indices&&>(indices)};
+    }
+
+    // Adds values(i) to dest(indices(i)) for every element of indices. Values may also be a scalar or a single
+    // element. Each task accumulates into its own heap-allocated copy of dest, and the copies are summed into dest
+    // at the end, so repeated indices never race.
+    template <typename Dest, typename Indices, typename Values>
+    void scatter_add(Dest& dest, const Indices& indices, const Values& values) {
+        static_assert(std::is_integral<typename internal::traits<Indices>::ScalarType>::value,
+            "Cannot scatter using non-integral indices");
+        static_assert(internal::traits<Indices>::indexingMode == 1, "Scatter indices must be contiguous");
+        static_assert(internal::traits<Dest>::size <= std::numeric_limits<int>::max(),
+            "Cannot scatter into Tensor3s beyond INT_MAX elements");
+        // Row-major Tensor3s beyond INT_MAX elements are evaluated by rows, and are reported by the size check above.
+        static_assert(internal::traits<Dest>::exprType == internal::ExpressionType::Tensor3
+            and (internal::traits<Dest>::indexingMode == 1 or internal::traits<Dest>::size > std::numeric_limits<int>::max()),
+            "Can only scatter into contiguous row-major Tensor3s");
+        static_assert(std::is_scalar<Values>::value or internal::traits<Values>::size == 1
+            or internal::traits<Values>::size == internal::traits<Indices>::size,
+            "Scatter values must be a scalar, a single element or one element per index");
+        static_assert(std::is_scalar<Values>::value or internal::traits<Values>::size == 1
+            or internal::traits<Values>::indexingMode == 1, "Scatter values must be contiguous");
+        using ScalarType = typename internal::traits<Dest>::ScalarType;
+        constexpr int destSize = internal::traits<Dest>::size, numIndices = internal::traits<Indices>::size;
+        // Tasks must be large enough to amortize clearing and merging their copies.
+        constexpr int grain = std::max(internal::kPARALLEL_GRAIN_SIZE, destSize);
+        auto* out = dest.data();
+
+        const auto scatter = [&indices, &values](ScalarType* target, int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                if constexpr (std::is_scalar<Values>::value) target[static_cast<int>(indices(i))] += values;
+                else if constexpr (internal::traits<Values>::size == 1) target[static_cast<int>(indices(i))] += values(0);
+                else target[static_cast<int>(indices(i))] += values(i);
+            }
+        };
+
+        if constexpr (numIndices <= grain) {
+            // Privatizing would cost more than the scatter itself.
+            scatter(out, 0, numIndices);
+        } else {
+            std::mutex outMutex;
+            internal::parallel_for(0, numIndices, grain, [&scatter, out, &outMutex](int begin, int end) {
+                std::vector<ScalarType> partial(destSize, ScalarType{});
+                scatter(partial.data(), begin, end);
+                std::lock_guard<std::mutex> lock{outMutex};
+                #pragma omp simd
+                for (int i = 0; i < destSize; ++i) {
+                    out[i] += partial[i];
+                }
+            });
+        }
+    }
+} /* Stealth::Tensor */
@@ -0,0 +1,59 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../Executors/CpuDispatch.hpp"
+#include "../Executors/Executor.hpp"
+#include "../utils.hpp"
+#include <algorithm>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace Stealth::Tensor {
+    namespace internal {
+        // Neighbouring elements are counted into separate copies of the bins, so that runs of the same value
+        // do not stall on each increment waiting for the previous one.
+        constexpr int kHISTOGRAM_LANES = 4;
+        // Beyond this many bins the lane copies no longer fit in cache, and a single copy is used.
+        constexpr int kHISTOGRAM_MAX_LANED_BINS = 1024;
+    } /* internal */
+
+    // Counts of each value in [0, numBins) across an integer expression. Values outside the range are skipped,
+    // so elements can be masked out, e.g. histogram(select(visible, owner, -1), numPlayers). Each task counts
+    // into its own bins, which are merged once at the end.
+    template <typename Expr>
+    std::vector<int> histogram(const Expr& expr, int numBins) {
+        static_assert(std::is_integral<typename internal::traits<Expr>::ScalarType>::value,
+            "Cannot compute a histogram of a non-integral expression");
+        constexpr int width = internal::traits<Expr>::width,
+            length = internal::traits<Expr>::length,
+            numRows = length * internal::traits<Expr>::height;
+        const int lanes = (numBins <= internal::kHISTOGRAM_MAX_LANED_BINS) ? internal::kHISTOGRAM_LANES : 1;
+        std::vector<int> counts(numBins, 0);
+        std::mutex countsMutex;
+        // Tasks must be large enough to amortize clearing and merging their bins.
+        const int grain = std::max(1, std::max(internal::kPARALLEL_GRAIN_SIZE, numBins * lanes) / width);
+        internal::parallel_for_dispatch(0, numRows, grain, [&expr, numBins, lanes, &counts, &countsMutex](int begin, int end) {
+            std::vector<int> bins(numBins * lanes, 0);
+            for (int row = begin; row < end; ++row) {
+                const int y = row % length, z = row / length;
+                for (int x = 0; x < width; ++x) {
+                    // Widened first, so the range test reads the same for signed and unsigned scalars.
+                    const long long value = static_cast<long long>(expr(x, y, z));
+                    if (value >= 0 and value < numBins) ++bins[static_cast<int>(value) * lanes + x % lanes];
+                }
+            }
+            std::lock_guard<std::mutex> lock{countsMutex};
+            for (int bin = 0; bin < numBins; ++bin) {
+                for (int lane = 0; lane < lanes; ++lane) counts[bin] += bins[bin * lanes + lane];
+            }
+        });
+        return counts;
+    }
+
+    // Number of distinct values in [0, numBins) that appear in an integer expression.
+    template <typename Expr>
+    int countUnique(const Expr& expr, int numBins) {
+        const std::vector<int> counts = histogram(expr, numBins);
+        return static_cast<int>(std::count_if(counts.begin(), counts.end(), [](int count) { return count > 0; }));
+    }
+} /* Stealth::Tensor */
@@ -0,0 +1,182 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../core/Tensor3.hpp"
+#include "../Executors/Executor.hpp"
+#include "../utils.hpp"
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace Stealth::Tensor {
+    // Component label of every tile, numbered from 0 in raster order of each component's first tile,
+    // along with the number of tiles in each component.
+    template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime>
+    struct Labeling {
+        Labeling() : labels{kUNINITIALIZED} { }
+
+        int numLabels() const noexcept {
+            return static_cast<int>(sizes.size());
+        }
+
+        Tensor3<int, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime> labels;
+        std::vector<int> sizes;
+    };
+
+    namespace internal {
+        // Tiles are labelled independently in blocks of this size before their borders are merged.
+        constexpr int kLABEL_BLOCK_WIDTH = 64, kLABEL_BLOCK_LENGTH = 64, kLABEL_BLOCK_HEIGHT = 8;
+
+        // Neighbours that come earlier in raster order. Each pair of neighbours is visited once, from the later tile.
+        template <Connectivity connectivity>
+        constexpr auto backward_neighbours() noexcept {
+            if constexpr (connectivity == Connectivity::Four) {
+                return std::array<std::array<int, 3>, 2>{{{-1, 0, 0}, {0, -1, 0}}};
+            } else if constexpr (connectivity == Connectivity::Eight) {
+                return std::array<std::array<int, 3>, 4>{{{-1, 0, 0}, {-1, -1, 0}, {0, -1, 0}, {1, -1, 0}}};
+            } else if constexpr (connectivity == Connectivity::Six) {
+                return std::array<std::array<int, 3>, 3>{{{-1, 0, 0}, {0, -1, 0}, {0, 0, -1}}};
+            } else {
+                std::array<std::array<int, 3>, 13> offsets{};
+                int numOffsets = 0;
+                for (int dz = -1; dz <= 0; ++dz) {
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            if (dz < 0 or dy < 0 or (dy == 0 and dx < 0)) offsets[numOffsets++] = {dx, dy, dz};
+                        }
+                    }
+                }
+                return offsets;
+            }
+        }
+
+        // Lock-free union-find in which every root is the smallest index of its set.
+        class ConcurrentDisjointSets {
+            public:
+                explicit ConcurrentDisjointSets(int size) : mParents{new std::atomic<int>[size]} {
+                    parallel_for(0, size, kPARALLEL_GRAIN_SIZE, [this](int begin, int end) {
+                        for (int i = begin; i < end; ++i) mParents[i].store(i, std::memory_order_relaxed);
+                    });
+                }
+
+                int find(int element) const noexcept {
+                    int parent = mParents[element].load(std::memory_order_relaxed);
+                    while (parent != element) {
+                        element = parent;
+                        parent = mParents[element].load(std::memory_order_relaxed);
+                    }
+                    return element;
+                }
+
+                void merge(int a, int b) noexcept {
+                    while (true) {
+                        a = find(a);
+                        b = find(b);
+                        if (a == b) return;
+                        if (a < b) std::swap(a, b);
+                        // Only link a while it is still a root; otherwise someone else got there first.
+                        int expected = a;
+                        if (mParents[a].compare_exchange_weak(expected, b)) return;
+                    }
+                }
+
+                std::atomic<int>& operator[](int element) noexcept {
+                    return mParents[element];
+                }
+            private:
+                std::unique_ptr<std::atomic<int>[]> mParents;
+        };
+    } /* internal */
+
+    // Labels connected components of tiles that are equivalent to their neighbours. The map is split into
+    // blocks that are labelled in parallel; the unions across block borders are then merged in parallel.
+    template <Connectivity connectivity = Connectivity::Four, typename Source, typename Equivalent = std::equal_to<>>
+    auto connectedComponents(const Source& source, Equivalent equivalent = {}) {
+        constexpr int width = internal::traits<Source>::width,
+            length = internal::traits<Source>::length,
+            height = internal::traits<Source>::height,
+            area = width * length;
+        constexpr bool crossLayers = connectivity == Connectivity::Six or connectivity == Connectivity::TwentySix;
+        constexpr int blockHeight = crossLayers ? internal::kLABEL_BLOCK_HEIGHT : 1;
+        constexpr int blocksX = (width + internal::kLABEL_BLOCK_WIDTH - 1) / internal::kLABEL_BLOCK_WIDTH,
+            blocksY = (length + internal::kLABEL_BLOCK_LENGTH - 1) / internal::kLABEL_BLOCK_LENGTH,
+            blocksZ = (height + blockHeight - 1) / blockHeight;
+        constexpr auto neighbours = internal::backward_neighbours<connectivity>();
+
+        internal::ConcurrentDisjointSets sets{width * length * height};
+        // Visits every neighbour pair whose earlier tile is (inside ? within : outside) the block.
+        const auto unite_block = [&](int block, bool inside) {
+            const int minX = (block % blocksX) * internal::kLABEL_BLOCK_WIDTH,
+                minY = (block / blocksX % blocksY) * internal::kLABEL_BLOCK_LENGTH,
+                minZ = (block / (blocksX * blocksY)) * blockHeight;
+            const int maxX = std::min(width, minX + internal::kLABEL_BLOCK_WIDTH),
+                maxY = std::min(length, minY + internal::kLABEL_BLOCK_LENGTH),
+                maxZ = std::min(height, minZ + blockHeight);
+            for (int z = minZ; z < maxZ; ++z) {
+                for (int y = minY; y < maxY; ++y) {
+                    for (int x = minX; x < maxX; ++x) {
+                        // Away from the faces of the block, every backward neighbour is inside it.
+                        const bool onBorder = x == minX or x == maxX - 1 or y == minY or y == maxY - 1
+                            or (crossLayers and z == minZ);
+                        if (not inside and not onBorder) continue;
+                        for (const auto& offset : neighbours) {
+                            const int nx = x + offset[0], ny = y + offset[1], nz = z + offset[2];
+                            if (nx < 0 or nx >= width or ny < 0 or ny >= length or nz < 0) continue;
+                            const bool neighbourInside = nx >= minX and nx < maxX and ny >= minY and ny < maxY
+                                and nz >= minZ;
+                            if (neighbourInside != inside) continue;
+                            if (equivalent(source(x, y, z), source(nx, ny, nz))) {
+                                sets.merge(x + y * width + z * area, nx + ny * width + nz * area);
+                            }
+                        }
+                    }
+                }
+            }
+        };
+        constexpr int numBlocks = blocksX * blocksY * blocksZ;
+        internal::parallel_for(0, numBlocks, 1, [&](int begin, int end) {
+            for (int block = begin; block < end; ++block) unite_block(block, true);
+        });
+        internal::parallel_for(0, numBlocks, 1, [&](int begin, int end) {
+            for (int block = begin; block < end; ++block) unite_block(block, false);
+        });
+
+        // Number the roots in raster order: count them per chunk, scan the counts, then hand out labels.
+        Labeling<width, length, height> result;
+        constexpr int size = width * length * height;
+        constexpr int numChunks = (size + internal::kPARALLEL_GRAIN_SIZE - 1) / internal::kPARALLEL_GRAIN_SIZE;
+        std::vector<int> chunkOffsets(numChunks + 1, 0);
+        internal::parallel_for(0, numChunks, 1, [&](int begin, int end) {
+            for (int chunk = begin; chunk < end; ++chunk) {
+                const int chunkEnd = std::min(size, (chunk + 1) * internal::kPARALLEL_GRAIN_SIZE);
+                int numRoots = 0;
+                for (int i = chunk * internal::kPARALLEL_GRAIN_SIZE; i < chunkEnd; ++i) {
+                    const int root = sets.find(i);
+                    result.labels(i) = root;
+                    numRoots += (root == i);
+                }
+                chunkOffsets[chunk + 1] = numRoots;
+            }
+        });
+        for (int chunk = 0; chunk < numChunks; ++chunk) chunkOffsets[chunk + 1] += chunkOffsets[chunk];
+        // Roots no longer need their parent entry, so it is reused to hold the root's label.
+        internal::parallel_for(0, numChunks, 1, [&](int begin, int end) {
+            for (int chunk = begin; chunk < end; ++chunk) {
+                const int chunkEnd = std::min(size, (chunk + 1) * internal::kPARALLEL_GRAIN_SIZE);
+                int nextLabel = chunkOffsets[chunk];
+                for (int i = chunk * internal::kPARALLEL_GRAIN_SIZE; i < chunkEnd; ++i) {
+                    if (result.labels(i) == i) sets[i].store(nextLabel++, std::memory_order_relaxed);
+                }
+            }
+        });
+        internal::parallel_for(0, size, internal::kPARALLEL_GRAIN_SIZE, [&](int begin, int end) {
+            for (int i = begin; i < end; ++i) {
+                result.labels(i) = sets[result.labels(i)].load(std::memory_order_relaxed);
+            }
+        });
+        result.sizes.assign(chunkOffsets[numChunks], 0);
+        for (int i = 0; i < size; ++i) ++result.sizes[result.labels(i)];
+        return result;
+    }
+} /* Stealth::Tensor */
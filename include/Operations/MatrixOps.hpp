@@ -3,7 +3,7 @@
 #include "ElemWiseBinaryOps.hpp"
 
 namespace Stealth::Tensor {
-    template <typename LHS, typename RHS>
+    template <typename LHS, typename RHS, internal::enable_if_expression<LHS, RHS> = 0>
     constexpr STEALTH_ALWAYS_INLINE auto operator*(LHS&& lhs, RHS&& rhs) {
         // If either one is a scalar, return a product.
         if constexpr (internal::traits<LHS>::is_scalar or internal::traits<RHS>::is_scalar) {
@@ -0,0 +1,121 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../Functors/BinaryFunctors.hpp"
+#include "../Functors/UnaryFunctors.hpp"
+#include "../utils.hpp"
+#include <cmath>
+#include <type_traits>
+
+namespace Stealth::Tensor::internal {
+    // Floating point constants are only reassociated, e.g. (a + 2) + 3 into a + 5, when the compiler
+    // itself is allowed to do so, since it can change the result.
+    #if defined(__FAST_MATH__) || defined(STEALTH_ALLOW_REASSOCIATION)
+        constexpr bool kALLOW_REASSOCIATION = true;
+    #else
+        constexpr bool kALLOW_REASSOCIATION = false;
+    #endif
+
+    template <template <typename, typename> class Functor, typename Op>
+    struct is_binary_functor : std::false_type { };
+
+    template <template <typename, typename> class Functor, typename LHS, typename RHS>
+    struct is_binary_functor<Functor, Functor<LHS, RHS>> : std::true_type { };
+
+    template <typename Operand>
+    constexpr bool is_constant_operand() noexcept {
+        using RawOperand = raw_type<Operand>;
+        return traits<RawOperand>::exprType == ExpressionType::Tensor3 and traits<RawOperand>::size == 1;
+    }
+
+    // Binary expression using Functor whose right-hand side is a constant held by value - i.e. one that
+    // was written as a plain number, rather than a Scalar that may still change.
+    template <template <typename, typename> class Functor, typename Expr>
+    struct has_constant_rhs : std::false_type { };
+
+    template <template <typename, typename> class Functor, typename LHS, typename Op, typename RHS>
+    struct has_constant_rhs<Functor, ElemWiseBinaryExpr<LHS, Op, RHS>> : std::bool_constant<
+        is_binary_functor<Functor, raw_type<Op>>::value and std::is_rvalue_reference<RHS>::value
+        and is_constant_operand<RHS>()> { };
+
+    // Whether (lhs op c1) op rhs can be rewritten as lhs op (c1 combine rhs).
+    template <template <typename, typename> class Functor, typename LHS, typename RHS>
+    constexpr bool can_fold_constants() noexcept {
+        if constexpr (!std::is_arithmetic<raw_type<RHS>>::value or !has_constant_rhs<Functor, raw_type<LHS>>::value) {
+            return false;
+        } else {
+            using ConstantType = typename traits<decltype(std::declval<raw_type<LHS>&>().rhsExpr())>::ScalarType;
+            return std::is_same<ConstantType, raw_type<RHS>>::value
+                and std::is_same<ConstantType, typename traits<raw_type<LHS>>::ScalarType>::value
+                and (std::is_integral<ConstantType>::value or kALLOW_REASSOCIATION);
+        }
+    }
+
+    // Hands on an operand stored inside an expression. Operands stored by reference stay references;
+    // copies are moved out when the enclosing expression is itself a temporary.
+    template <typename Stored, typename Outer, typename Operand>
+    constexpr STEALTH_ALWAYS_INLINE decltype(auto) forward_stored(Operand& operand) noexcept {
+        if constexpr (std::is_reference<Stored>::value or std::is_lvalue_reference<Outer>::value) return (operand);
+        else return raw_type<Operand>{std::move(operand)};
+    }
+
+    // !!x where x is already boolean.
+    template <typename Expr>
+    struct is_double_negation : std::false_type { };
+
+    template <typename Op, typename LHS>
+    struct is_double_negation<ElemWiseUnaryExpr<Op, LHS>> : std::bool_constant<
+        std::is_same<raw_type<Op>, functors::notOp<scalar_element<LHS>>>::value
+        and std::is_same<typename traits<LHS>::ScalarType, bool>::value> { };
+
+    // Identity operations are found at evaluation time, since the constants are runtime values.
+    // Returns which operand is the constant: 0 for neither, 1 for the left, 2 for the right.
+    template <typename Expr>
+    constexpr int identity_constant_side() noexcept {
+        using RawExpr = raw_type<Expr>;
+        if constexpr (traits<RawExpr>::exprType != ExpressionType::ElemWiseBinaryExpr) {
+            return 0;
+        } else {
+            using Op = raw_type<decltype(std::declval<const RawExpr&>().operation())>;
+            using LHS = raw_type<decltype(std::declval<const RawExpr&>().lhsExpr())>;
+            using RHS = raw_type<decltype(std::declval<const RawExpr&>().rhsExpr())>;
+            using ScalarType = typename traits<RawExpr>::ScalarType;
+            constexpr bool commutative = is_binary_functor<functors::add, Op>::value
+                or is_binary_functor<functors::multiply, Op>::value;
+            constexpr bool hasIdentity = commutative or is_binary_functor<functors::subtract, Op>::value
+                or is_binary_functor<functors::divide, Op>::value;
+            if constexpr (!hasIdentity) {
+                return 0;
+            } else if constexpr (is_constant_operand<RHS>() and traits<LHS>::size == traits<RawExpr>::size
+                and std::is_same<typename traits<LHS>::ScalarType, ScalarType>::value) {
+                return 2;
+            } else if constexpr (commutative and is_constant_operand<LHS>() and traits<RHS>::size == traits<RawExpr>::size
+                and std::is_same<typename traits<RHS>::ScalarType, ScalarType>::value) {
+                return 1;
+            } else {
+                return 0;
+            }
+        }
+    }
+
+    template <typename Expr>
+    constexpr STEALTH_ALWAYS_INLINE const auto& identity_operand(const Expr& expr) noexcept {
+        if constexpr (identity_constant_side<Expr>() == 2) return expr.lhsExpr();
+        else return expr.rhsExpr();
+    }
+
+    template <typename Expr>
+    inline bool is_identity(const Expr& expr) noexcept {
+        using Op = raw_type<decltype(expr.operation())>;
+        const auto constant = (identity_constant_side<Expr>() == 2) ? expr.rhsExpr()(0) : expr.lhsExpr()(0);
+        using ConstantType = raw_type<decltype(constant)>;
+        if constexpr (is_binary_functor<functors::multiply, Op>::value or is_binary_functor<functors::divide, Op>::value) {
+            return constant == ConstantType(1);
+        } else if constexpr (std::is_floating_point<ConstantType>::value) {
+            // Adding +0 (or subtracting -0) turns -0 into +0, so it is only an identity under fast math.
+            const bool additive = is_binary_functor<functors::add, Op>::value;
+            return constant == ConstantType(0) and (kALLOW_REASSOCIATION or std::signbit(constant) == additive);
+        } else {
+            return constant == ConstantType(0);
+        }
+    }
+} /* Stealth::Tensor::internal */
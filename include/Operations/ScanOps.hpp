@@ -0,0 +1,183 @@
+#pragma once
+#include "../core/ForwardDeclarations.hpp"
+#include "../Executors/CpuDispatch.hpp"
+#include "../Executors/Executor.hpp"
+#include "../Functors/BinaryFunctors.hpp"
+#include "../utils.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace Stealth::Tensor {
+    namespace internal {
+        // Rows at least this long are split into chunks which are scanned in parallel.
+        constexpr int kSCAN_CHUNK_SIZE = 4096;
+        // Number of columns carried together when scanning along y or z.
+        constexpr int kSCAN_LANES = 256;
+        // Rows are scanned in blocks of kSCAN_TILES tiles of kSCAN_TILE elements each.
+        constexpr int kSCAN_TILE = 16;
+        constexpr int kSCAN_TILES = 8;
+
+        // Scans [begin, end) of row (y, z) starting from carry, and returns the carry into whatever follows. Without
+        // store, only the carry is computed. Each block first scans its tiles independently, as interleaved chains
+        // of operations rather than one long dependent chain, then a vectorized fix-up pass offsets every tile by
+        // the carry into it.
+        template <bool inclusive, bool store, typename Dest, typename Source, typename BinaryOperation, typename ScalarType>
+        constexpr ScalarType scan_row_range(Dest& dest, const Source& source, BinaryOperation& op, ScalarType carry,
+            int y, int z, int begin, int end) {
+            constexpr int blockSize = kSCAN_TILE * kSCAN_TILES;
+            ScalarType tiles[kSCAN_TILES][kSCAN_TILE];
+            int blockBegin = begin;
+            for (; blockBegin + blockSize <= end; blockBegin += blockSize) {
+                for (int tile = 0; tile < kSCAN_TILES; ++tile) {
+                    #pragma omp simd
+                    for (int i = 0; i < kSCAN_TILE; ++i) {
+                        tiles[tile][i] = static_cast<ScalarType>(source(blockBegin + tile * kSCAN_TILE + i, y, z));
+                    }
+                }
+                for (int i = 1; i < kSCAN_TILE; ++i) {
+                    for (int tile = 0; tile < kSCAN_TILES; ++tile) {
+                        tiles[tile][i] = op(tiles[tile][i - 1], tiles[tile][i]);
+                    }
+                }
+                for (int tile = 0; tile < kSCAN_TILES; ++tile) {
+                    const int tileBegin = blockBegin + tile * kSCAN_TILE;
+                    if constexpr (store and inclusive) {
+                        #pragma omp simd
+                        for (int i = 0; i < kSCAN_TILE; ++i) {
+                            dest(tileBegin + i, y, z) = op(carry, tiles[tile][i]);
+                        }
+                    } else if constexpr (store) {
+                        dest(tileBegin, y, z) = carry;
+                        #pragma omp simd
+                        for (int i = 1; i < kSCAN_TILE; ++i) {
+                            dest(tileBegin + i, y, z) = op(carry, tiles[tile][i - 1]);
+                        }
+                    }
+                    carry = op(carry, tiles[tile][kSCAN_TILE - 1]);
+                }
+            }
+            // Whatever is left is shorter than a block.
+            for (int x = blockBegin; x < end; ++x) {
+                const ScalarType value = static_cast<ScalarType>(source(x, y, z));
+                if constexpr (store and not inclusive) dest(x, y, z) = carry;
+                carry = op(carry, value);
+                if constexpr (store and inclusive) dest(x, y, z) = carry;
+            }
+            return carry;
+        }
+
+        // Work-efficient blocked scan of a single row: reduce each chunk in parallel, scan the
+        // chunk totals, then rescan each chunk in parallel starting from its offset.
+        template <bool inclusive, typename Dest, typename Source, typename BinaryOperation, typename ScalarType>
+        constexpr void scan_row_parallel(Dest& dest, const Source& source, BinaryOperation& op,
+            ScalarType identity, int y, int z) {
+            constexpr int width = internal::traits<Dest>::width;
+            constexpr int numChunks = (width + kSCAN_CHUNK_SIZE - 1) / kSCAN_CHUNK_SIZE;
+            std::array<ScalarType, numChunks> offsets;
+            internal::parallel_for_dispatch(0, numChunks, 1, [&](int begin, int end) {
+                for (int chunk = begin; chunk < end; ++chunk) {
+                    offsets[chunk] = scan_row_range<inclusive, false>(dest, source, op, identity, y, z,
+                        chunk * kSCAN_CHUNK_SIZE, std::min(width, (chunk + 1) * kSCAN_CHUNK_SIZE));
+                }
+            });
+            ScalarType carry = identity;
+            for (int chunk = 0; chunk < numChunks; ++chunk) {
+                const ScalarType total = offsets[chunk];
+                offsets[chunk] = carry;
+                carry = op(carry, total);
+            }
+            internal::parallel_for_dispatch(0, numChunks, 1, [&](int begin, int end) {
+                for (int chunk = begin; chunk < end; ++chunk) {
+                    scan_row_range<inclusive, true>(dest, source, op, offsets[chunk], y, z,
+                        chunk * kSCAN_CHUNK_SIZE, std::min(width, (chunk + 1) * kSCAN_CHUNK_SIZE));
+                }
+            });
+        }
+
+        template <bool inclusive, typename Dest, typename Source, typename BinaryOperation, typename ScalarType>
+        constexpr void scan_rows(Dest& dest, const Source& source, BinaryOperation& op, ScalarType identity) {
+            constexpr int width = internal::traits<Dest>::width,
+                length = internal::traits<Dest>::length,
+                height = internal::traits<Dest>::height;
+            if constexpr (length * height < 4 and width >= 2 * kSCAN_CHUNK_SIZE) {
+                // Too few rows to keep every thread busy.
+                for (int z = 0; z < height; ++z) {
+                    for (int y = 0; y < length; ++y) {
+                        scan_row_parallel<inclusive>(dest, source, op, identity, y, z);
+                    }
+                }
+            } else {
+                internal::parallel_for_dispatch(0, length * height, internal::row_grain(width), [&](int begin, int end) {
+                    for (int row = begin; row < end; ++row) {
+                        scan_row_range<inclusive, true>(dest, source, op, identity, row % length, row / length, 0, width);
+                    }
+                });
+            }
+        }
+
+        // Scans along y (axis 1) or z (axis 2). Neighbouring columns are independent, so they are
+        // carried together in simd lanes, and groups of lanes are spread across threads.
+        template <int axis, bool inclusive, typename Dest, typename Source, typename BinaryOperation, typename ScalarType>
+        constexpr void scan_columns(Dest& dest, const Source& source, BinaryOperation& op, ScalarType identity) {
+            constexpr int width = internal::traits<Dest>::width;
+            constexpr int scanLength = (axis == 1) ? internal::traits<Dest>::length : internal::traits<Dest>::height;
+            constexpr int otherLength = (axis == 1) ? internal::traits<Dest>::height : internal::traits<Dest>::length;
+            constexpr int numLaneGroups = (width + kSCAN_LANES - 1) / kSCAN_LANES;
+            constexpr int grain = std::max(1, kPARALLEL_GRAIN_SIZE / (std::min(kSCAN_LANES, width) * scanLength));
+            internal::parallel_for_dispatch(0, otherLength * numLaneGroups, grain, [&](int begin, int end) {
+                for (int index = begin; index < end; ++index) {
+                    const int other = index / numLaneGroups, group = index % numLaneGroups;
+                    const int minX = group * kSCAN_LANES, numLanes = std::min(kSCAN_LANES, width - minX);
+                    std::array<ScalarType, kSCAN_LANES> carry;
+                    carry.fill(identity);
+                    for (int i = 0; i < scanLength; ++i) {
+                        const int y = (axis == 1) ? i : other, z = (axis == 1) ? other : i;
+                        #pragma omp simd
+                        for (int lane = 0; lane < numLanes; ++lane) {
+                            const ScalarType value = static_cast<ScalarType>(source(minX + lane, y, z));
+                            if constexpr (!inclusive) dest(minX + lane, y, z) = carry[lane];
+                            carry[lane] = op(carry[lane], value);
+                            if constexpr (inclusive) dest(minX + lane, y, z) = carry[lane];
+                        }
+                    }
+                }
+            });
+        }
+    } /* internal */
+
+    // Scans source along the given axis (0 = x, 1 = y, 2 = z) and writes the result into dest,
+    // which may be a Tensor3 or a writable view such as a BlockExpr. Exclusive scans start from identity.
+    template <int axis, bool inclusive = true, typename Dest, typename Source, typename BinaryOperation>
+    constexpr void scan(Dest&& dest, const Source& source, BinaryOperation&& op,
+        typename internal::traits<Dest>::ScalarType identity) {
+        static_assert(axis >= 0 and axis < 3, "Scan axis must be 0, 1 or 2");
+        static_assert(internal::traits<Dest>::width == internal::traits<Source>::width
+            and internal::traits<Dest>::length == internal::traits<Source>::length
+            and internal::traits<Dest>::height == internal::traits<Source>::height,
+            "Cannot scan into incompatible Tensor3");
+        if constexpr (axis == 0) internal::scan_rows<inclusive>(dest, source, op, identity);
+        else internal::scan_columns<axis, inclusive>(dest, source, op, identity);
+    }
+
+    template <int axis, bool inclusive = true, typename Dest, typename Source>
+    constexpr STEALTH_ALWAYS_INLINE void cumsum(Dest&& dest, const Source& source) {
+        using ScalarType = typename internal::traits<Dest>::ScalarType;
+        scan<axis, inclusive>(std::forward<Dest&&>(dest), source, internal::functors::add<ScalarType, ScalarType>{},
+            ScalarType{});
+    }
+
+    template <int axis, bool inclusive = true, typename Dest, typename Source>
+    constexpr STEALTH_ALWAYS_INLINE void cummax(Dest&& dest, const Source& source) {
+        using ScalarType = typename internal::traits<Dest>::ScalarType;
+        scan<axis, inclusive>(std::forward<Dest&&>(dest), source, internal::functors::max<ScalarType, ScalarType>{},
+            std::numeric_limits<ScalarType>::lowest());
+    }
+
+    template <int axis, bool inclusive = true, typename Dest, typename Source>
+    constexpr STEALTH_ALWAYS_INLINE void cummin(Dest&& dest, const Source& source) {
+        using ScalarType = typename internal::traits<Dest>::ScalarType;
+        scan<axis, inclusive>(std::forward<Dest&&>(dest), source, internal::functors::min<ScalarType, ScalarType>{},
+            std::numeric_limits<ScalarType>::max());
+    }
+} /* Stealth::Tensor */
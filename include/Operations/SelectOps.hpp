@@ -0,0 +1,15 @@
+#pragma once
+#include "../Expressions/SelectExpr.hpp"
+#include "../core/ForwardDeclarations.hpp"
+
+namespace Stealth::Tensor {
+    // Element-wise equivalent of cond ? lhs : rhs. Any operand may be a scalar.
+    template <typename _Cond, typename _LHS, typename _RHS>
+    constexpr STEALTH_ALWAYS_INLINE auto select(_Cond&& cond, _LHS&& lhs, _RHS&& rhs) noexcept {
+        using Cond = tensor3_type<_Cond>;
+        using LHS = tensor3_type<_LHS>;
+        using RHS = tensor3_type<_RHS>;
+        return SelectExpr<Cond&&, LHS&&, RHS&&>{std::forward<Cond&&>(cond), std::forward<LHS&&>(lhs),
+            std::forward<RHS&&>(rhs)};
+    }
+} /* Stealth::Tensor */
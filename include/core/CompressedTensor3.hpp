@@ -0,0 +1,331 @@
+#pragma once
+#include "ForwardDeclarations.hpp"
+#include "Tensor3.hpp"
+#include "../Executors/Executor.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Stealth::Tensor {
+    namespace internal {
+        // Small enough that palette indices and run ends fit in a byte.
+        constexpr int kCOMPRESSED_CHUNK_WIDTH = 16;
+        constexpr int kCOMPRESSED_CHUNK_LENGTH = 16;
+
+        template <typename type, int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime>
+        struct traits<CompressedTensor3<type, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>>
+            : traits<Tensor3<type, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>> {
+            static constexpr ExpressionType exprType = ExpressionType::CompressedTensor3;
+            static constexpr int indexingMode = 3;
+        };
+
+        // Bits per palette index, rounded up to a power of two so that no index straddles two words.
+        constexpr STEALTH_ALWAYS_INLINE int palette_bits(int paletteSize) noexcept {
+            int bits = 0;
+            while ((1 << bits) < paletteSize) ++bits;
+            int rounded = (bits == 0) ? 0 : 1;
+            while (rounded < bits) rounded *= 2;
+            return rounded;
+        }
+
+        // One chunk of a layer, stored as a palette of the distinct values it holds plus, for each element,
+        // an index into the palette. Indices are either bit-packed or run-length encoded within each row,
+        // whichever is smaller. Chunks holding a single value need nothing beyond the palette.
+        template <typename ScalarType>
+        class CompressedChunk {
+            static constexpr int kMAX_AREA = kCOMPRESSED_CHUNK_WIDTH * kCOMPRESSED_CHUNK_LENGTH;
+            static constexpr int kWORD_BITS = 64;
+
+            public:
+                CompressedChunk() : mPalette(1, ScalarType{}) { }
+
+                // Encodes width * length values laid out row by row.
+                void encode(const ScalarType* values, int width, int length) {
+                    const int area = width * length;
+                    mWidth = width;
+                    mPalette.assign(values, values + area);
+                    std::sort(mPalette.begin(), mPalette.end());
+                    mPalette.erase(std::unique(mPalette.begin(), mPalette.end()), mPalette.end());
+                    mPalette.shrink_to_fit();
+                    mBits = palette_bits(static_cast<int>(mPalette.size()));
+                    mPacked.clear();
+                    mRunEnds.clear();
+                    mRunIndices.clear();
+                    mRowRuns.clear();
+                    if (mBits == 0) return;
+
+                    unsigned char indices[kMAX_AREA];
+                    int numRuns = 0;
+                    for (int i = 0; i < area; ++i) {
+                        indices[i] = static_cast<unsigned char>(std::distance(mPalette.begin(),
+                            std::lower_bound(mPalette.begin(), mPalette.end(), values[i])));
+                        numRuns += (i % width == 0) or (indices[i] != indices[i - 1]);
+                    }
+                    const int numWords = (area * mBits + kWORD_BITS - 1) / kWORD_BITS;
+                    if (2 * (numRuns + length + 1) < numWords * static_cast<int>(sizeof(std::uint64_t))) {
+                        mRowRuns.reserve(length + 1);
+                        mRunEnds.reserve(numRuns);
+                        mRunIndices.reserve(numRuns);
+                        for (int y = 0; y < length; ++y) {
+                            mRowRuns.push_back(static_cast<unsigned short>(mRunEnds.size()));
+                            for (int x = 0; x < width; ++x) {
+                                const unsigned char index = indices[x + y * width];
+                                if (x == 0 or index != mRunIndices.back()) {
+                                    mRunEnds.push_back(0);
+                                    mRunIndices.push_back(index);
+                                }
+                                mRunEnds.back() = static_cast<unsigned char>(x + 1);
+                            }
+                        }
+                        mRowRuns.push_back(static_cast<unsigned short>(mRunEnds.size()));
+                    } else {
+                        mPacked.assign(numWords, 0);
+                        for (int i = 0; i < area; ++i) {
+                            mPacked[i * mBits / kWORD_BITS] |= std::uint64_t{indices[i]} << (i * mBits % kWORD_BITS);
+                        }
+                    }
+                }
+
+                ScalarType operator()(int x, int y) const {
+                    if (mBits == 0) return mPalette[0];
+                    if (mPacked.empty()) {
+                        int run = mRowRuns[y];
+                        while (mRunEnds[run] <= x) ++run;
+                        return mPalette[mRunIndices[run]];
+                    }
+                    return mPalette[packed_index(x + y * mWidth)];
+                }
+
+                // Writes the values of row y from minX up to maxX into out.
+                void decodeRow(int y, int minX, int maxX, ScalarType* out) const {
+                    if (mBits == 0) {
+                        std::fill(out, out + (maxX - minX), mPalette[0]);
+                    } else if (mPacked.empty()) {
+                        int x = minX;
+                        for (int run = mRowRuns[y]; x < maxX; ++run) {
+                            const int end = std::min(static_cast<int>(mRunEnds[run]), maxX);
+                            if (x < end) {
+                                std::fill(out + (x - minX), out + (end - minX), mPalette[mRunIndices[run]]);
+                                x = end;
+                            }
+                        }
+                    } else {
+                        const int offset = y * mWidth;
+                        for (int x = minX; x < maxX; ++x) out[x - minX] = mPalette[packed_index(x + offset)];
+                    }
+                }
+
+                std::size_t bytes() const noexcept {
+                    return sizeof(*this) + mPalette.capacity() * sizeof(ScalarType) + mPacked.capacity() * sizeof(std::uint64_t)
+                        + mRunEnds.capacity() + mRunIndices.capacity() + mRowRuns.capacity() * sizeof(unsigned short);
+                }
+
+                bool isRunLength() const noexcept {
+                    return mBits != 0 and mPacked.empty();
+                }
+            private:
+                STEALTH_ALWAYS_INLINE int packed_index(int i) const noexcept {
+                    const int bit = i * mBits;
+                    return static_cast<int>((mPacked[bit / kWORD_BITS] >> (bit % kWORD_BITS)) & ((std::uint64_t{1} << mBits) - 1));
+                }
+
+                std::vector<ScalarType> mPalette;
+                std::vector<std::uint64_t> mPacked;
+                // Runs end at mRunEnds (exclusive) within their row, and the runs of row y start at mRowRuns[y].
+                std::vector<unsigned char> mRunEnds, mRunIndices;
+                std::vector<unsigned short> mRowRuns;
+                int mWidth = 1, mBits = 0;
+        };
+    } /* internal */
+
+    // Read-mostly Tensor3 for layers with few distinct values, which are held in compressed chunks. Assigning
+    // to a Tensor3 decodes whole rows at a time. Reads through other expressions use the const accessors and
+    // decode single elements: runs restart at every chunk row, and chunks are only run-length encoded when they
+    // have few runs, so each read scans only a handful. That measured about twice as fast as caching decoded
+    // row segments per thread. Non-const accesses decode the containing chunk into a dense buffer, where it
+    // stays until flush() re-encodes every such chunk. Non-const accesses are not thread-safe.
+    template <typename ScalarType, int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime>
+    class CompressedTensor3 : public Tensor3Base<CompressedTensor3<ScalarType, widthAtCompileTime, lengthAtCompileTime,
+        heightAtCompileTime>> {
+        static_assert(std::is_arithmetic<ScalarType>::value, "CompressedTensor3 only supports arithmetic types");
+        static constexpr int kCHUNK_WIDTH = internal::kCOMPRESSED_CHUNK_WIDTH, kCHUNK_LENGTH = internal::kCOMPRESSED_CHUNK_LENGTH;
+        static constexpr int kCHUNKS_X = (widthAtCompileTime + kCHUNK_WIDTH - 1) / kCHUNK_WIDTH;
+        static constexpr int kCHUNKS_Y = (lengthAtCompileTime + kCHUNK_LENGTH - 1) / kCHUNK_LENGTH;
+        static constexpr int kNUM_CHUNKS = kCHUNKS_X * kCHUNKS_Y * heightAtCompileTime;
+
+        public:
+            using Chunk = internal::CompressedChunk<ScalarType>;
+
+            CompressedTensor3() : mChunks(kNUM_CHUNKS), mDecoded(kNUM_CHUNKS) { }
+
+            template <typename OtherTensor3>
+            CompressedTensor3(const OtherTensor3& other) : CompressedTensor3() {
+                (*this) = other;
+            }
+
+            // Encodes every chunk straight from the expression, discarding any unflushed writes.
+            template <typename OtherTensor3>
+            CompressedTensor3& operator=(const OtherTensor3& other) {
+                static_assert(internal::traits<OtherTensor3>::width == widthAtCompileTime
+                    and internal::traits<OtherTensor3>::length == lengthAtCompileTime
+                    and internal::traits<OtherTensor3>::height == heightAtCompileTime,
+                    "Cannot copy incompatible Tensor3 into CompressedTensor3");
+                internal::parallel_for(0, kNUM_CHUNKS, 1, [this, &other](int begin, int end) {
+                    ScalarType values[kCHUNK_WIDTH * kCHUNK_LENGTH];
+                    for (int chunk = begin; chunk < end; ++chunk) {
+                        const Region region = chunk_region(chunk);
+                        const int chunkWidth = region.maxX - region.minX;
+                        for (int y = region.minY; y < region.maxY; ++y) {
+                            for (int x = region.minX; x < region.maxX; ++x) {
+                                values[(x - region.minX) + (y - region.minY) * chunkWidth] = other(x, y, region.minZ);
+                            }
+                        }
+                        mChunks[chunk].encode(values, chunkWidth, region.maxY - region.minY);
+                        mDecoded[chunk].reset();
+                    }
+                });
+                mDirty.clear();
+                return *this;
+            }
+
+            // Accessors
+            ScalarType& operator()(int x, int y, int z) {
+                const int chunk = chunk_index(x, y, z);
+                if (mDecoded[chunk] == nullptr) decode_chunk(chunk);
+                return mDecoded[chunk][offset_in_chunk(chunk, x, y)];
+            }
+
+            ScalarType operator()(int x, int y, int z) const {
+                const int chunk = chunk_index(x, y, z);
+                if (mDecoded[chunk]) return mDecoded[chunk][offset_in_chunk(chunk, x, y)];
+                return mChunks[chunk](x % kCHUNK_WIDTH, y % kCHUNK_LENGTH);
+            }
+
+            // The lower dimensional accessors fold the remaining axes into the last one.
+            ScalarType& operator()(int x, int y) {
+                return (*this)(x, y % lengthAtCompileTime, y / lengthAtCompileTime);
+            }
+
+            ScalarType operator()(int x, int y) const {
+                return (*this)(x, y % lengthAtCompileTime, y / lengthAtCompileTime);
+            }
+
+            ScalarType& operator()(int x) {
+                return (*this)(x % widthAtCompileTime, x / widthAtCompileTime);
+            }
+
+            ScalarType operator()(int x) const {
+                return (*this)(x % widthAtCompileTime, x / widthAtCompileTime);
+            }
+
+            // Writes row (y, z) into out, which must hold widthAtCompileTime elements.
+            void decodeRow(int y, int z, ScalarType* out) const {
+                for (int chunkX = 0; chunkX < kCHUNKS_X; ++chunkX) {
+                    decode_segment(chunkX, y, z, out + chunkX * kCHUNK_WIDTH);
+                }
+            }
+
+            // Decodes into dest a chunk-wide segment of a row at a time, e.g. when a Tensor3 is assigned from this.
+            template <typename Dest>
+            void copyTo(Dest& dest) const {
+                internal::parallel_for(0, lengthAtCompileTime * heightAtCompileTime, internal::row_grain(widthAtCompileTime),
+                    [this, &dest](int begin, int end) {
+                        ScalarType segment[kCHUNK_WIDTH];
+                        for (int index = begin; index < end; ++index) {
+                            const int y = index % lengthAtCompileTime, z = index / lengthAtCompileTime;
+                            for (int chunkX = 0; chunkX < kCHUNKS_X; ++chunkX) {
+                                const int minX = chunkX * kCHUNK_WIDTH, maxX = std::min(minX + kCHUNK_WIDTH, widthAtCompileTime);
+                                decode_segment(chunkX, y, z, segment);
+                                #pragma omp simd
+                                for (int x = minX; x < maxX; ++x) {
+                                    dest(x, y, z) = segment[x - minX];
+                                }
+                            }
+                        }
+                    });
+            }
+
+            // Re-encodes every chunk written to since the last flush and releases their buffers.
+            void flush() {
+                internal::parallel_for(0, static_cast<int>(mDirty.size()), 1, [this](int begin, int end) {
+                    for (int i = begin; i < end; ++i) {
+                        const int chunk = mDirty[i];
+                        const Region region = chunk_region(chunk);
+                        mChunks[chunk].encode(mDecoded[chunk].get(), region.maxX - region.minX, region.maxY - region.minY);
+                        mDecoded[chunk].reset();
+                    }
+                });
+                mDirty.clear();
+            }
+
+            STEALTH_ALWAYS_INLINE int numDirtyChunks() const noexcept {
+                return static_cast<int>(mDirty.size());
+            }
+
+            STEALTH_ALWAYS_INLINE const Chunk& chunk(int x, int y, int z) const noexcept {
+                return mChunks[chunk_index(x, y, z)];
+            }
+
+            // Memory held by the compressed chunks and any decoded buffers.
+            std::size_t bytes() const noexcept {
+                std::size_t total = sizeof(*this);
+                for (int chunk = 0; chunk < kNUM_CHUNKS; ++chunk) {
+                    total += mChunks[chunk].bytes() + sizeof(mDecoded[chunk]);
+                    if (mDecoded[chunk]) total += chunk_area(chunk) * sizeof(ScalarType);
+                }
+                return total + mDirty.capacity() * sizeof(int);
+            }
+        private:
+            // Writes the part of row (y, z) held by chunk column chunkX into out.
+            void decode_segment(int chunkX, int y, int z, ScalarType* out) const {
+                const int chunk = chunk_index(chunkX * kCHUNK_WIDTH, y, z);
+                const int minX = chunkX * kCHUNK_WIDTH, maxX = std::min(minX + kCHUNK_WIDTH, widthAtCompileTime);
+                if (mDecoded[chunk]) {
+                    const ScalarType* row = &mDecoded[chunk][offset_in_chunk(chunk, minX, y)];
+                    std::copy(row, row + (maxX - minX), out);
+                } else {
+                    mChunks[chunk].decodeRow(y % kCHUNK_LENGTH, 0, maxX - minX, out);
+                }
+            }
+
+            static constexpr STEALTH_ALWAYS_INLINE int chunk_index(int x, int y, int z) noexcept {
+                return x / kCHUNK_WIDTH + kCHUNKS_X * (y / kCHUNK_LENGTH + kCHUNKS_Y * z);
+            }
+
+            static constexpr Region chunk_region(int chunk) noexcept {
+                const int minX = (chunk % kCHUNKS_X) * kCHUNK_WIDTH, minY = (chunk / kCHUNKS_X % kCHUNKS_Y) * kCHUNK_LENGTH,
+                    z = chunk / (kCHUNKS_X * kCHUNKS_Y);
+                return Region{minX, minY, z, std::min(minX + kCHUNK_WIDTH, widthAtCompileTime),
+                    std::min(minY + kCHUNK_LENGTH, lengthAtCompileTime), z + 1};
+            }
+
+            static constexpr int chunk_area(int chunk) noexcept {
+                const Region region = chunk_region(chunk);
+                return (region.maxX - region.minX) * (region.maxY - region.minY);
+            }
+
+            // Position of (x, y) within the decoded buffer of its chunk, which is as wide as the chunk.
+            static constexpr STEALTH_ALWAYS_INLINE int offset_in_chunk(int chunk, int x, int y) noexcept {
+                const int minX = (chunk % kCHUNKS_X) * kCHUNK_WIDTH;
+                return (x - minX) + (y % kCHUNK_LENGTH) * (std::min(minX + kCHUNK_WIDTH, widthAtCompileTime) - minX);
+            }
+
+            void decode_chunk(int chunk) {
+                const Region region = chunk_region(chunk);
+                const int chunkWidth = region.maxX - region.minX;
+                mDecoded[chunk] = std::make_unique<ScalarType[]>(chunk_area(chunk));
+                for (int y = 0; y < region.maxY - region.minY; ++y) {
+                    mChunks[chunk].decodeRow(y, 0, chunkWidth, &mDecoded[chunk][y * chunkWidth]);
+                }
+                mDirty.push_back(chunk);
+            }
+
+            std::vector<Chunk> mChunks;
+            std::vector<std::unique_ptr<ScalarType[]>> mDecoded;
+            std::vector<int> mDirty;
+    };
+} /* Stealth::Tensor */
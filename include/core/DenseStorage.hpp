@@ -1,26 +1,35 @@
 #pragma once
+#include "ForwardDeclarations.hpp"
+#include "../Executors/Executor.hpp"
+#include <algorithm>
 #include <array>
+#include <cstddef>
+#include <cstdlib>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <iostream>
 
 namespace Stealth::Tensor::internal {
     // Below this threshold, small storage optimizations apply.
     constexpr int kSMALL_THRESHOLD = 16;
 
-    template <int sizeAtCompileTime>
+    template <long long sizeAtCompileTime>
     constexpr bool requiresHeapAllocation() {
         return sizeAtCompileTime > kSMALL_THRESHOLD;
     }
 
     // In most cases, do a heap allocation, but for small sizes, use in-object storage.
-    template <typename ScalarType, int sizeAtCompileTime, bool isLarge = requiresHeapAllocation<sizeAtCompileTime>()>
+    template <typename ScalarType, long long sizeAtCompileTime, bool isLarge = requiresHeapAllocation<sizeAtCompileTime>()>
     class InternalContainer { };
 
-    template <typename ScalarType, int sizeAtCompileTime>
+    template <typename ScalarType, long long sizeAtCompileTime>
     class InternalContainer<ScalarType, sizeAtCompileTime, false> {
         public:
             constexpr STEALTH_ALWAYS_INLINE InternalContainer() : mData{} { }
 
+            STEALTH_ALWAYS_INLINE InternalContainer(Uninitialized) { }
+
             constexpr STEALTH_ALWAYS_INLINE auto& operator*() noexcept {
                 return mData;
             }
@@ -32,19 +41,46 @@ namespace Stealth::Tensor::internal {
             std::array<ScalarType, sizeAtCompileTime> mData;
     };
 
-    template <typename ScalarType, int sizeAtCompileTime>
+    template <typename ScalarType, long long sizeAtCompileTime>
     class InternalContainer<ScalarType, sizeAtCompileTime, true> {
         using ContainerType = std::array<ScalarType, sizeAtCompileTime>;
+        // Trivial element types are allocated with calloc/malloc, so zeroing can be left to the OS.
+        static constexpr bool kRAW_ALLOCATION = std::is_trivially_default_constructible<ScalarType>::value
+            and std::is_trivially_destructible<ScalarType>::value
+            and alignof(ContainerType) <= alignof(std::max_align_t);
+
+        struct Deleter {
+            STEALTH_ALWAYS_INLINE void operator()(ContainerType* data) const noexcept {
+                if constexpr (kRAW_ALLOCATION) std::free(data);
+                else delete data;
+            }
+        };
+
+        // Allocations this large always come straight from the OS in calloc, as zero pages that no thread has
+        // written yet. glibc's mmap threshold grows up to 32 MB, so smaller ones may be served from the heap, where
+        // calloc would zero them on the allocating thread instead.
+        static constexpr long long kLAZY_ZERO_BYTES = 32ll << 20;
+        static constexpr bool kZERO_ON_ALLOCATION = not kRAW_ALLOCATION
+            or static_cast<long long>(sizeof(ContainerType)) >= kLAZY_ZERO_BYTES;
 
         public:
-            constexpr STEALTH_ALWAYS_INLINE InternalContainer() : mData{new std::array<ScalarType, sizeAtCompileTime>} { }
+            // Each page is placed on a NUMA node on its first write. Lazily zeroed pages are first written inside
+            // the executor-partitioned kernels; anything smaller is zeroed here in parallel, split the same way.
+            STEALTH_ALWAYS_INLINE InternalContainer() : mData{allocate(kZERO_ON_ALLOCATION)} {
+                if constexpr (not kZERO_ON_ALLOCATION) first_touch();
+            }
 
-            constexpr STEALTH_ALWAYS_INLINE InternalContainer(const InternalContainer& other) {
-                mData = std::make_unique<ContainerType>(*other.mData);
+            // Leaves the elements uninitialized. The caller must write every element before reading it.
+            STEALTH_ALWAYS_INLINE InternalContainer(Uninitialized) : mData{allocate(false)} { }
+
+            STEALTH_ALWAYS_INLINE InternalContainer(const InternalContainer& other) : mData{allocate(false)} {
+                copy_from(other);
             }
 
-            constexpr STEALTH_ALWAYS_INLINE InternalContainer& operator=(const InternalContainer& other) {
-                mData = std::make_unique<ContainerType>(*other.mData);
+            STEALTH_ALWAYS_INLINE InternalContainer& operator=(const InternalContainer& other) {
+                // Reuse the existing pages rather than reallocating, so their placement is kept.
+                if (this != &other) copy_from(other);
+                return *this;
             }
 
             constexpr STEALTH_ALWAYS_INLINE auto& operator*() noexcept {
@@ -55,14 +91,42 @@ namespace Stealth::Tensor::internal {
                 return (*mData);
             }
         private:
-            std::unique_ptr<ContainerType> mData;
+            std::unique_ptr<ContainerType, Deleter> mData;
+
+            static STEALTH_ALWAYS_INLINE ContainerType* allocate(bool zeroed) {
+                if constexpr (kRAW_ALLOCATION) {
+                    void* data = zeroed ? std::calloc(1, sizeof(ContainerType)) : std::malloc(sizeof(ContainerType));
+                    if (data == nullptr) throw std::bad_alloc{};
+                    return static_cast<ContainerType*>(data);
+                } else {
+                    return zeroed ? new ContainerType{} : new ContainerType;
+                }
+            }
+
+            STEALTH_ALWAYS_INLINE void first_touch() {
+                using Index = index_type<sizeAtCompileTime>;
+                parallel_for_flat(Index{sizeAtCompileTime}, kPARALLEL_GRAIN_SIZE, [this](Index begin, Index end) {
+                    std::fill(mData -> data() + begin, mData -> data() + end, ScalarType{});
+                });
+            }
+
+            // Copies in parallel, split the same way evaluation kernels split their work, so that on NUMA
+            // systems each thread's slab of the tensor is placed on that thread's node.
+            STEALTH_ALWAYS_INLINE void copy_from(const InternalContainer& other) {
+                using Index = index_type<sizeAtCompileTime>;
+                parallel_for_flat(Index{sizeAtCompileTime}, kPARALLEL_GRAIN_SIZE, [this, &other](Index begin, Index end) {
+                    std::copy(other.mData -> data() + begin, other.mData -> data() + end, mData -> data() + begin);
+                });
+            }
     };
 
-    template <typename ScalarType, int sizeAtCompileTime>
+    template <typename ScalarType, long long sizeAtCompileTime>
     class DenseStorage {
         public:
             constexpr STEALTH_ALWAYS_INLINE DenseStorage() { }
 
+            STEALTH_ALWAYS_INLINE DenseStorage(Uninitialized) : mData{kUNINITIALIZED} { }
+
             // Move constructor.
             // constexpr STEALTH_ALWAYS_INLINE DenseStorage(DenseStorage&& other) {
             //     mData = move(other.mData);
@@ -82,11 +146,11 @@ namespace Stealth::Tensor::internal {
             //     mData = other.mData;
             // }
 
-            constexpr STEALTH_ALWAYS_INLINE auto& operator[](int index) {
+            constexpr STEALTH_ALWAYS_INLINE auto& operator[](index_type<sizeAtCompileTime> index) {
                 return (*mData)[index];
             }
 
-            constexpr STEALTH_ALWAYS_INLINE const auto& operator[](int index) const {
+            constexpr STEALTH_ALWAYS_INLINE const auto& operator[](index_type<sizeAtCompileTime> index) const {
                 return (*mData)[index];
             }
 
@@ -94,6 +158,14 @@ namespace Stealth::Tensor::internal {
                 return sizeAtCompileTime;
             }
 
+            constexpr STEALTH_ALWAYS_INLINE auto data() noexcept {
+                return (*mData).data();
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto data() const noexcept {
+                return (*mData).data();
+            }
+
             constexpr STEALTH_ALWAYS_INLINE auto begin() const noexcept {
                 return (*mData).begin();
             }
@@ -0,0 +1,270 @@
+#pragma once
+#include "ForwardDeclarations.hpp"
+#include "Tensor3.hpp"
+#include "../Executors/Executor.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Stealth::Tensor {
+    namespace internal {
+        constexpr STEALTH_ALWAYS_INLINE int bit_width(unsigned value) noexcept {
+            #ifdef __GNUC__
+                return value ? 32 - __builtin_clz(value) : 0;
+            #else
+                int bits = 0;
+                for (; value; value >>= 1) ++bits;
+                return bits;
+            #endif
+        }
+
+        // Monotone priority queue: keys may never be pushed below the last key popped. Each element moves
+        // down through at most 33 buckets, so no matter how large the costs, push and pop are amortized O(log C).
+        class RadixHeap {
+            public:
+                void push(unsigned key, int value) {
+                    mBuckets[bit_width(key ^ mLast)].emplace_back(key, value);
+                    ++mSize;
+                }
+
+                std::pair<unsigned, int> pop() {
+                    if (mBuckets[0].empty()) {
+                        int bucket = 1;
+                        while (mBuckets[bucket].empty()) ++bucket;
+                        // Every key here shares a higher prefix with the new minimum than with the old one.
+                        mLast = std::min_element(mBuckets[bucket].begin(), mBuckets[bucket].end())[0].first;
+                        for (int i = 0; i < static_cast<int>(mBuckets[bucket].size()); ++i) {
+                            const auto entry = mBuckets[bucket][i];
+                            mBuckets[bit_width(entry.first ^ mLast)].push_back(entry);
+                        }
+                        mBuckets[bucket].clear();
+                    }
+                    const std::pair<unsigned, int> top = mBuckets[0].back();
+                    mBuckets[0].pop_back();
+                    --mSize;
+                    return top;
+                }
+
+                bool empty() const noexcept {
+                    return mSize == 0;
+                }
+            private:
+                std::array<std::vector<std::pair<unsigned, int>>, 33> mBuckets;
+                unsigned mLast = 0;
+                int mSize = 0;
+        };
+
+        template <Connectivity connectivity>
+        constexpr auto flow_neighbours() noexcept {
+            static_assert(connectivity == Connectivity::Four or connectivity == Connectivity::Six,
+                "Flow fields only support Four or Six connectivity");
+            if constexpr (connectivity == Connectivity::Four) {
+                return std::array<std::array<int, 3>, 4>{{{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}}};
+            } else {
+                return std::array<std::array<int, 3>, 6>{{{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}}};
+            }
+        }
+    } /* internal */
+
+    // Integration field holding the cheapest cost from every tile to its nearest goal, and a direction field
+    // pointing each tile at the neighbour to step to next. Entering a tile costs its value in the cost map;
+    // tiles that cost less than 1 are impassable. Rebuilding after a local change to the cost map is
+    // usually unnecessary: repair() only recomputes the tiles whose paths ran through the changed region.
+    template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime, Connectivity connectivity>
+    class FlowField {
+        static constexpr int kSIZE = widthAtCompileTime * lengthAtCompileTime * heightAtCompileTime;
+        static constexpr auto kNEIGHBOURS = internal::flow_neighbours<connectivity>();
+
+        public:
+            using Goal = std::array<int, 3>;
+            static constexpr int kUNREACHABLE = std::numeric_limits<int>::max();
+            // Directions are indices into neighbours(), or one of these.
+            static constexpr signed char kGOAL = -1, kBLOCKED = -2;
+
+            FlowField() : mIntegration{kUNINITIALIZED}, mDirections{kUNINITIALIZED} { }
+
+            template <typename Costs>
+            FlowField(const Costs& costs, std::vector<Goal> goals) : FlowField() {
+                build(costs, std::move(goals));
+            }
+
+            static constexpr const auto& neighbours() noexcept {
+                return kNEIGHBOURS;
+            }
+
+            template <typename Costs>
+            void build(const Costs& costs, std::vector<Goal> goals) {
+                assert_cost_compatibility<Costs>();
+                mGoals = std::move(goals);
+                mIntegration = kUNREACHABLE;
+                mDirections = kBLOCKED;
+                internal::RadixHeap heap;
+                for (int goal = 0; goal < static_cast<int>(mGoals.size()); ++goal) {
+                    const int index = to_index(mGoals[goal][0], mGoals[goal][1], mGoals[goal][2]);
+                    mIntegration(index) = 0;
+                    mDirections(index) = kGOAL;
+                    heap.push(0, index);
+                }
+                propagate(costs, heap, nullptr);
+                internal::parallel_for(0, kSIZE, internal::kPARALLEL_GRAIN_SIZE, [this](int begin, int end) {
+                    for (int index = begin; index < end; ++index) update_direction(index);
+                });
+            }
+
+            // Brings the field up to date after the costs inside region have changed.
+            template <typename Costs>
+            void repair(const Costs& costs, const Region& region) {
+                assert_cost_compatibility<Costs>();
+                // Everything downstream of the region may have been relying on its old costs.
+                std::vector<int> invalidated;
+                for (int z = std::max(0, region.minZ); z < std::min(heightAtCompileTime, region.maxZ); ++z) {
+                    for (int y = std::max(0, region.minY); y < std::min(lengthAtCompileTime, region.maxY); ++y) {
+                        for (int x = std::max(0, region.minX); x < std::min(widthAtCompileTime, region.maxX); ++x) {
+                            invalidate(to_index(x, y, z), invalidated);
+                        }
+                    }
+                }
+                for (int i = 0; i < static_cast<int>(invalidated.size()); ++i) {
+                    const int parent = invalidated[i];
+                    for_each_neighbour(parent, [this, parent, &invalidated](int child, int) {
+                        const signed char direction = mDirections(child);
+                        if (direction >= 0 and neighbour_index(child, direction) == parent) invalidate(child, invalidated);
+                    });
+                }
+                // Restart from the cheapest way into each invalidated tile from the tiles that are still valid.
+                internal::RadixHeap heap;
+                for (int i = 0; i < static_cast<int>(invalidated.size()); ++i) {
+                    const int index = invalidated[i];
+                    const int cost = tile_cost(costs, index);
+                    if (cost < 1) continue;
+                    int cheapest = kUNREACHABLE;
+                    for_each_neighbour(index, [this, &cheapest](int neighbour, int) {
+                        cheapest = std::min(cheapest, mIntegration(neighbour));
+                    });
+                    if (cheapest != kUNREACHABLE) {
+                        mIntegration(index) = cheapest + cost;
+                        heap.push(cheapest + cost, index);
+                    }
+                }
+                std::vector<int>& changed = invalidated;
+                propagate(costs, heap, &changed);
+                for (int i = 0; i < static_cast<int>(changed.size()); ++i) {
+                    update_direction(changed[i]);
+                    for_each_neighbour(changed[i], [this](int neighbour, int) { update_direction(neighbour); });
+                }
+            }
+
+            // Repairs the region covered by a block of the cost map, e.g. after block<8, 8>(costs, x, y) = kWALL.
+            template <typename Costs, int blockWidth, int blockLength, int blockHeight, typename Underlying>
+            void repair(const Costs& costs, const BlockExpr<blockWidth, blockLength, blockHeight, Underlying>& changed) {
+                const auto offsets = changed.offsets();
+                repair(costs, Region{offsets[0], offsets[1], offsets[2],
+                    offsets[0] + blockWidth, offsets[1] + blockLength, offsets[2] + blockHeight});
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& integration() const noexcept {
+                return mIntegration;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& directions() const noexcept {
+                return mDirections;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const std::vector<Goal>& goals() const noexcept {
+                return mGoals;
+            }
+
+            // The tile to move to from (x, y, z). Goals and unreachable tiles stay where they are.
+            constexpr STEALTH_ALWAYS_INLINE Goal next(int x, int y, int z = 0) const noexcept {
+                const signed char direction = mDirections(x, y, z);
+                if (direction < 0) return Goal{x, y, z};
+                return Goal{x + kNEIGHBOURS[direction][0], y + kNEIGHBOURS[direction][1], z + kNEIGHBOURS[direction][2]};
+            }
+        private:
+            template <typename Costs>
+            static constexpr void assert_cost_compatibility() noexcept {
+                static_assert(internal::traits<Costs>::width == widthAtCompileTime
+                    and internal::traits<Costs>::length == lengthAtCompileTime
+                    and internal::traits<Costs>::height == heightAtCompileTime, "Cost map must match the flow field");
+            }
+
+            static constexpr STEALTH_ALWAYS_INLINE int to_index(int x, int y, int z) noexcept {
+                return x + widthAtCompileTime * (y + lengthAtCompileTime * z);
+            }
+
+            static constexpr STEALTH_ALWAYS_INLINE int neighbour_index(int index, int direction) noexcept {
+                return index + to_index(kNEIGHBOURS[direction][0], kNEIGHBOURS[direction][1], kNEIGHBOURS[direction][2]);
+            }
+
+            template <typename Costs>
+            static constexpr STEALTH_ALWAYS_INLINE int tile_cost(const Costs& costs, int index) {
+                return static_cast<int>(costs(index % widthAtCompileTime, index / widthAtCompileTime % lengthAtCompileTime,
+                    index / (widthAtCompileTime * lengthAtCompileTime)));
+            }
+
+            // Calls function(neighbour, direction) for every neighbour of index that lies inside the field.
+            template <typename Function>
+            static constexpr STEALTH_ALWAYS_INLINE void for_each_neighbour(int index, Function&& function) {
+                const int x = index % widthAtCompileTime, y = index / widthAtCompileTime % lengthAtCompileTime,
+                    z = index / (widthAtCompileTime * lengthAtCompileTime);
+                for (int direction = 0; direction < static_cast<int>(kNEIGHBOURS.size()); ++direction) {
+                    const int nx = x + kNEIGHBOURS[direction][0], ny = y + kNEIGHBOURS[direction][1],
+                        nz = z + kNEIGHBOURS[direction][2];
+                    if (nx < 0 or nx >= widthAtCompileTime or ny < 0 or ny >= lengthAtCompileTime
+                        or nz < 0 or nz >= heightAtCompileTime) continue;
+                    function(to_index(nx, ny, nz), direction);
+                }
+            }
+
+            void invalidate(int index, std::vector<int>& invalidated) {
+                // Goals cost nothing to reach regardless of the cost map.
+                if (mDirections(index) == kGOAL) return;
+                mIntegration(index) = kUNREACHABLE;
+                mDirections(index) = kBLOCKED;
+                invalidated.push_back(index);
+            }
+
+            // Dijkstra from everything in the heap, optionally recording every tile that improves.
+            template <typename Costs>
+            void propagate(const Costs& costs, internal::RadixHeap& heap, std::vector<int>* changed) {
+                while (not heap.empty()) {
+                    const auto [distance, index] = heap.pop();
+                    if (static_cast<int>(distance) != mIntegration(index)) continue;
+                    for_each_neighbour(index, [&](int neighbour, int) {
+                        const int cost = tile_cost(costs, neighbour);
+                        if (cost < 1) return;
+                        const int candidate = static_cast<int>(distance) + cost;
+                        if (candidate < mIntegration(neighbour)) {
+                            mIntegration(neighbour) = candidate;
+                            heap.push(candidate, neighbour);
+                            if (changed) changed -> push_back(neighbour);
+                        }
+                    });
+                }
+            }
+
+            // Points a tile at its cheapest neighbour, which is strictly cheaper since every step costs at least 1.
+            void update_direction(int index) {
+                if (mDirections(index) == kGOAL) return;
+                if (mIntegration(index) == kUNREACHABLE) {
+                    mDirections(index) = kBLOCKED;
+                    return;
+                }
+                int cheapest = mIntegration(index);
+                signed char best = kBLOCKED;
+                for_each_neighbour(index, [this, &cheapest, &best](int neighbour, int direction) {
+                    if (mIntegration(neighbour) < cheapest) {
+                        cheapest = mIntegration(neighbour);
+                        best = static_cast<signed char>(direction);
+                    }
+                });
+                mDirections(index) = best;
+            }
+
+            Tensor3<int, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime> mIntegration;
+            Tensor3<signed char, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime> mDirections;
+            std::vector<Goal> mGoals;
+    };
+} /* Stealth::Tensor */
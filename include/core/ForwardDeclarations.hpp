@@ -20,21 +20,38 @@
     }
 #endif
 
+#include <cstdint>
+#include <limits>
+#include <type_traits>
 
 namespace Stealth::Tensor {
     namespace internal {
+        // Flat indices stay int, which vectorizes better, unless there are more elements than int can count.
+        template <long long size>
+        using index_type = typename std::conditional<(size > std::numeric_limits<int>::max()), std::int64_t, int>::type;
+
         enum class ExpressionType : int {
             Unknown = 0,
             Tensor3,
             ElemWiseBinaryExpr,
             ElemWiseUnaryExpr,
-            BlockExpr
+            BlockExpr,
+            SelectExpr,
+            StridedExpr,
+            PermuteExpr,
+            GatherExpr,
+            ReshapeExpr,
+            PoolExpr,
+            TrackedTensor3,
+            RingTensor3,
+            CompressedTensor3
         };
 
         template <typename T> struct traits {
             using ScalarType = T;
-            static constexpr int width = 1, length = 1, height = 1, area = 1, size = 1,
-                indexingMode = 1;
+            static constexpr int width = 1, length = 1, height = 1, indexingMode = 1;
+            // Element counts can exceed INT_MAX, even though each dimension cannot.
+            static constexpr long long area = 1, size = 1;
             static constexpr bool is_scalar = size == 1;
             static constexpr bool is_vector = !is_scalar and (width == size or length == size or height == size);
             static constexpr bool is_matrix = !is_vector and (width == 1 or length == 1 or height == 1);
@@ -44,18 +61,89 @@ namespace Stealth::Tensor {
         template <typename T> struct traits<T&> : traits<T> { };
         template <typename T> struct traits<const T&> : traits<T> { };
         template <typename T> struct traits<T&&> : traits<T> { };
+
+        // Whether T is a Tensor3 or an expression, i.e. has an exprType. The element-wise operators are only
+        // considered when one of their operands is, so that pointers, iterators and smart pointers in this
+        // namespace keep their usual comparisons and arithmetic.
+        template <typename T, typename = void>
+        struct is_expression : std::false_type { };
+
+        template <typename T>
+        struct is_expression<T, std::void_t<decltype(traits<T>::exprType)>> : std::true_type { };
+
+        template <typename... Operands>
+        using enable_if_expression = typename std::enable_if<(is_expression<Operands>::value or ...), int>::type;
     } /* internal */
 
+    // How windows are combined when pooling.
+    enum class PoolingMode : int {
+        Average = 0,
+        Min,
+        Max
+    };
+
+    // Neighbourhoods of a tile. Four and Eight stay within a layer; Six and TwentySix also cross layers.
+    enum class Connectivity : int {
+        Four = 4,
+        Eight = 8,
+        Six = 6,
+        TwentySix = 26
+    };
+
+    // How an assignment writes its destination. Auto streams past the cache only when the
+    // destination is too large to fit in it.
+    enum class StorePolicy : int {
+        Auto = 0,
+        Cached,
+        Streaming
+    };
+
+    // Tag for constructing a Tensor3 without initializing its elements, e.g. when every element
+    // is about to be overwritten anyway.
+    struct Uninitialized {
+        explicit constexpr Uninitialized() = default;
+    };
+    constexpr Uninitialized kUNINITIALIZED{};
+
+    // Half-open box [minX, maxX) x [minY, maxY) x [minZ, maxZ).
+    struct Region {
+        int minX = 0, minY = 0, minZ = 0, maxX = 0, maxY = 0, maxZ = 0;
+
+        constexpr STEALTH_ALWAYS_INLINE bool empty() const noexcept {
+            return minX >= maxX or minY >= maxY or minZ >= maxZ;
+        }
+    };
+
     // Tensor3Base
     template <typename Derived>
     class Tensor3Base;
 
+    // Storage layouts, see Layout.hpp.
+    struct RowMajor;
+
+    template <int tileWidth = 8, int tileLength = 8>
+    struct Tiled;
+
+    struct Morton;
+
     // Tensor3
     template <typename type, int widthAtCompileTime = 1, int lengthAtCompileTime = 1, int heightAtCompileTime = 1,
-        int areaAtCompileTime = widthAtCompileTime * lengthAtCompileTime, int sizeAtCompileTime
-        = widthAtCompileTime * lengthAtCompileTime * heightAtCompileTime>
+        typename Layout = RowMajor, long long areaAtCompileTime = static_cast<long long>(widthAtCompileTime) * lengthAtCompileTime,
+        long long sizeAtCompileTime = areaAtCompileTime * heightAtCompileTime>
     class Tensor3;
 
+    // Tensor3 that records which regions have been written to.
+    template <typename type, int widthAtCompileTime = 1, int lengthAtCompileTime = 1, int heightAtCompileTime = 1>
+    class TrackedTensor3;
+
+    // Tensor3 whose origin can be moved without moving its elements.
+    template <typename type, int widthAtCompileTime = 1, int lengthAtCompileTime = 1, int heightAtCompileTime = 1>
+    class RingTensor3;
+
+    // Tensor3 stored as palette-compressed chunks.
+    template <typename type, int widthAtCompileTime = 1, int lengthAtCompileTime = 1, int heightAtCompileTime = 1>
+    class CompressedTensor3;
+
     // Binary Op
 
     template <typename LHS, typename BinaryOperation, typename RHS>
@@ -65,10 +153,57 @@ namespace Stealth::Tensor {
     template <typename UnaryOperation, typename LHS>
     class ElemWiseUnaryExpr;
 
+    // Conditional select between two operands.
+    template <typename Cond, typename LHS, typename RHS>
+    class SelectExpr;
+
+    // Lookup of table elements by an index Tensor3.
+    template <typename Table, typename Indices>
+    class GatherExpr;
+
     // View of a section of a Tensor3 or OpStruct
     template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime, typename Tensor3Type>
     class BlockExpr;
 
+    // View of every n-th element of a Tensor3 or OpStruct along each axis.
+    template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime,
+        int strideX, int strideY, int strideZ, typename Tensor3Type>
+    class StridedExpr;
+
+    // View of a contiguous range of a Tensor3 or OpStruct with different dimensions.
+    template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime, typename Tensor3Type>
+    class ReshapeExpr;
+
+    // Non-overlapping window reduction over a Tensor3 or OpStruct.
+    template <int windowX, int windowY, int windowZ, PoolingMode mode, typename Tensor3Type>
+    class PoolExpr;
+
+    // Stack of successively 2x downsampled levels.
+    template <typename type, int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime,
+        int numLevels, PoolingMode mode = PoolingMode::Average>
+    class Pyramid;
+
+    // Inclusive prefix sums along every axis, for constant time region sums.
+    template <typename type, int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime = 1>
+    class SummedAreaTable;
+
+    // Shortest-path costs to a set of goals and the direction to step from every tile.
+    template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime = 1,
+        Connectivity connectivity = Connectivity::Four>
+    class FlowField;
+
+    // Deduplicated strings, referred to by integer handles.
+    class StringPool;
+    using StringHandle = int;
+
+    // Struct-of-arrays map with one Tensor3 plane per field tag.
+    template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime, typename... Fields>
+    class TileMap;
+
+    // View of a Tensor3 or OpStruct with its axes reordered.
+    template <int axisX, int axisY, int axisZ, typename Tensor3Type>
+    class PermuteExpr;
+
     // Convenience typedefs
     template <int widthAtCompileTime = 1, int lengthAtCompileTime = 1, int heightAtCompileTime = 1>
     using Tensor3I = Tensor3<int, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>;
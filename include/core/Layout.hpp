@@ -0,0 +1,176 @@
+#pragma once
+#include "ForwardDeclarations.hpp"
+#include "../utils.hpp"
+#include <algorithm>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+namespace Stealth::Tensor {
+    // Layouts map coordinates to positions in storage. Apart from RowMajor, each one splits every layer into
+    // bricks which are contiguous in storage, so that square neighbourhoods touch few cache lines and pages.
+    // Storage is padded out to whole bricks, and the flat accessor of a Tensor3 indexes storage directly. Kernels
+    // never read the padding, whose contents are unspecified.
+
+    // x fastest, then y, then z.
+    struct RowMajor {
+        template <int width, int length, int height>
+        static constexpr long long kSTORAGE_SIZE = static_cast<long long>(width) * length * height;
+
+        template <int width, int length, int height>
+        static constexpr STEALTH_ALWAYS_INLINE auto index(int x, int y, int z) noexcept {
+            using Index = internal::index_type<kSTORAGE_SIZE<width, length, height>>;
+            return x + (length == 1 ? Index{0} : Index{y} * width) + (height == 1 ? Index{0} : Index{z} * (Index{width} * length));
+        }
+    };
+
+    // Row-major grid of tileWidth x tileLength bricks in each layer, each of which is row-major internally.
+    template <int tileWidth, int tileLength>
+    struct Tiled {
+        static_assert(tileWidth > 0 and tileLength > 0, "Tiles must not be empty");
+        static constexpr int kBRICK_WIDTH = tileWidth, kBRICK_LENGTH = tileLength;
+
+        template <int width, int length>
+        static constexpr int kBRICKS_X = (width + tileWidth - 1) / tileWidth;
+
+        template <int width, int length>
+        static constexpr int kBRICKS_PER_LAYER = kBRICKS_X<width, length> * ((length + tileLength - 1) / tileLength);
+
+        template <int width, int length, int height>
+        static constexpr long long kSTORAGE_SIZE = static_cast<long long>(kBRICKS_PER_LAYER<width, length>) * tileWidth
+            * tileLength * height;
+
+        template <int width, int length, int height>
+        static constexpr STEALTH_ALWAYS_INLINE auto index(int x, int y, int z) noexcept {
+            using Index = internal::index_type<kSTORAGE_SIZE<width, length, height>>;
+            const Index brick = x / tileWidth + (y / tileLength) * kBRICKS_X<width, length>
+                + Index{z} * kBRICKS_PER_LAYER<width, length>;
+            return brick * (tileWidth * tileLength) + (x % tileWidth) + (y % tileLength) * tileWidth;
+        }
+
+        template <int width, int length>
+        static constexpr STEALTH_ALWAYS_INLINE std::array<int, 2> brickOrigin(int brick) noexcept {
+            return {(brick % kBRICKS_X<width, length>) * tileWidth, (brick / kBRICKS_X<width, length>) * tileLength};
+        }
+    };
+
+    namespace internal {
+        // Spaces out the low 16 bits of value so that they occupy the even bits.
+        constexpr STEALTH_ALWAYS_INLINE unsigned spread_bits(unsigned value) noexcept {
+            value &= 0x0000FFFFu;
+            value = (value | (value << 8)) & 0x00FF00FFu;
+            value = (value | (value << 4)) & 0x0F0F0F0Fu;
+            value = (value | (value << 2)) & 0x33333333u;
+            value = (value | (value << 1)) & 0x55555555u;
+            return value;
+        }
+
+        // Inverse of spread_bits.
+        constexpr STEALTH_ALWAYS_INLINE unsigned gather_bits(unsigned value) noexcept {
+            value &= 0x55555555u;
+            value = (value | (value >> 1)) & 0x33333333u;
+            value = (value | (value >> 2)) & 0x0F0F0F0Fu;
+            value = (value | (value >> 4)) & 0x00FF00FFu;
+            value = (value | (value >> 8)) & 0x0000FFFFu;
+            return value;
+        }
+
+        constexpr int next_power_of_two(int value) noexcept {
+            int power = 1;
+            while (power < value) power *= 2;
+            return power;
+        }
+    } /* internal */
+
+    // Z-order curve within each layer. Each axis is padded to a power of two separately, and the layer is a row
+    // of Z-ordered squares as large as the shorter axis allows, so elongated maps are not padded out to a square.
+    // Aligned squares of any power-of-two size up to that are contiguous, so locality holds at every scale
+    // rather than at a single tile size.
+    struct Morton {
+        template <int width, int length>
+        static constexpr int kSIDE_X = internal::next_power_of_two(width);
+
+        template <int width, int length>
+        static constexpr int kSIDE_Y = internal::next_power_of_two(length);
+
+        template <int width, int length>
+        static constexpr int kSQUARE_SIDE = std::min(kSIDE_X<width, length>, kSIDE_Y<width, length>);
+
+        template <int width, int length>
+        static constexpr int kBRICK_SIDE = std::min(8, kSQUARE_SIDE<width, length>);
+
+        template <int width, int length>
+        static constexpr int kBRICKS_PER_LAYER = (kSIDE_X<width, length> / kBRICK_SIDE<width, length>)
+            * (kSIDE_Y<width, length> / kBRICK_SIDE<width, length>);
+
+        template <int width, int length, int height>
+        static constexpr long long kSTORAGE_SIZE = static_cast<long long>(kSIDE_X<width, length>) * kSIDE_Y<width, length> * height;
+
+        template <int width, int length, int height>
+        static constexpr STEALTH_ALWAYS_INLINE auto index(int x, int y, int z) noexcept {
+            using Index = internal::index_type<kSTORAGE_SIZE<width, length, height>>;
+            constexpr int side = kSQUARE_SIDE<width, length>;
+            // Only one of x and y can extend past the first square.
+            const Index square = x / side + y / side;
+            return square * (side * side) + static_cast<Index>(internal::spread_bits(x % side) | (internal::spread_bits(y % side) << 1))
+                + Index{z} * (Index{kSIDE_X<width, length>} * kSIDE_Y<width, length>);
+        }
+
+        template <int width, int length>
+        static constexpr STEALTH_ALWAYS_INLINE std::array<int, 2> brickOrigin(int brick) noexcept {
+            constexpr int side = kSQUARE_SIDE<width, length>, brickSide = kBRICK_SIDE<width, length>;
+            constexpr int bricksPerSquare = (side / brickSide) * (side / brickSide);
+            const int square = brick / bricksPerSquare, code = brick % bricksPerSquare;
+            const int x = static_cast<int>(internal::gather_bits(code)) * brickSide,
+                y = static_cast<int>(internal::gather_bits(code >> 1)) * brickSide;
+            if constexpr (kSIDE_X<width, length> > kSIDE_Y<width, length>) return {x + square * side, y};
+            else return {x, y + square * side};
+        }
+    };
+
+    namespace internal {
+        template <typename Layout>
+        constexpr bool is_row_major = std::is_same<Layout, RowMajor>::value;
+
+        template <typename Layout, int width, int length>
+        constexpr STEALTH_ALWAYS_INLINE std::array<int, 2> brick_size() noexcept {
+            if constexpr (std::is_same<Layout, Morton>::value) {
+                return {Morton::kBRICK_SIDE<width, length>, Morton::kBRICK_SIDE<width, length>};
+            } else {
+                return {Layout::kBRICK_WIDTH, Layout::kBRICK_LENGTH};
+            }
+        }
+
+        // Whether every element of expr can be read at the same flat storage index as in a Tensor3 with the given
+        // layout and shape, i.e. its only leaves are such Tensor3s or scalars.
+        template <typename Layout, int width, int length, int height, typename Expr>
+        constexpr bool shares_layout() noexcept {
+            using RawExpr = raw_type<Expr>;
+            if constexpr (std::is_scalar<RawExpr>::value) {
+                return true;
+            } else {
+                using ExprTraits = traits<RawExpr>;
+                constexpr ExpressionType exprType = ExprTraits::exprType;
+                if constexpr (ExprTraits::size == 1) {
+                    return true;
+                } else if constexpr (ExprTraits::width != width or ExprTraits::length != length
+                    or ExprTraits::height != height) {
+                    return false;
+                } else if constexpr (exprType == ExpressionType::Tensor3) {
+                    return std::is_same<typename ExprTraits::LayoutType, Layout>::value;
+                } else if constexpr (exprType == ExpressionType::ElemWiseUnaryExpr) {
+                    return shares_layout<Layout, width, length, height, decltype(std::declval<const RawExpr&>().lhsExpr())>();
+                } else if constexpr (exprType == ExpressionType::ElemWiseBinaryExpr) {
+                    return shares_layout<Layout, width, length, height, decltype(std::declval<const RawExpr&>().lhsExpr())>()
+                        and shares_layout<Layout, width, length, height, decltype(std::declval<const RawExpr&>().rhsExpr())>();
+                } else if constexpr (exprType == ExpressionType::SelectExpr) {
+                    return shares_layout<Layout, width, length, height, decltype(std::declval<const RawExpr&>().condExpr())>()
+                        and shares_layout<Layout, width, length, height, decltype(std::declval<const RawExpr&>().lhsExpr())>()
+                        and shares_layout<Layout, width, length, height, decltype(std::declval<const RawExpr&>().rhsExpr())>();
+                } else {
+                    return false;
+                }
+            }
+        }
+    } /* internal */
+} /* Stealth::Tensor */
@@ -0,0 +1,112 @@
+#pragma once
+#include "ForwardDeclarations.hpp"
+#include "StreamingStores.hpp"
+#include "../utils.hpp"
+#include <algorithm>
+#include <utility>
+
+#ifndef STEALTH_PREFETCH_DISTANCE
+    // How far ahead of the current position, in bytes of the destination, each stream is prefetched.
+    // Define as 0 to disable software prefetching.
+    #define STEALTH_PREFETCH_DISTANCE 1024
+#endif
+
+namespace Stealth::Tensor::internal {
+    constexpr int kPREFETCH_DISTANCE_BYTES = STEALTH_PREFETCH_DISTANCE;
+    // Contiguous evaluation with fewer streams than this is left to the hardware prefetcher.
+    constexpr int kPREFETCH_MIN_STREAMS = 4;
+    // Contiguous kernels issue prefetches once per this many elements.
+    constexpr int kPREFETCH_CHUNK_SIZE = 64;
+
+    // Number of leaf Tensor3s an expression reads from. Expressions with irregular access patterns
+    // (gathers, strided and permuted views, ...) contribute none.
+    template <typename Expr>
+    constexpr int prefetch_stream_count() noexcept {
+        using RawExpr = raw_type<Expr>;
+        constexpr ExpressionType exprType = traits<RawExpr>::exprType;
+        if constexpr (exprType == ExpressionType::Tensor3 or exprType == ExpressionType::TrackedTensor3) {
+            return 1;
+        } else if constexpr (exprType == ExpressionType::BlockExpr) {
+            return prefetch_stream_count<decltype(std::declval<const RawExpr&>().underlyingTensor3())>();
+        } else if constexpr (exprType == ExpressionType::ElemWiseUnaryExpr) {
+            return prefetch_stream_count<decltype(std::declval<const RawExpr&>().lhsExpr())>();
+        } else if constexpr (exprType == ExpressionType::ElemWiseBinaryExpr) {
+            return prefetch_stream_count<decltype(std::declval<const RawExpr&>().lhsExpr())>()
+                + prefetch_stream_count<decltype(std::declval<const RawExpr&>().rhsExpr())>();
+        } else if constexpr (exprType == ExpressionType::SelectExpr) {
+            return prefetch_stream_count<decltype(std::declval<const RawExpr&>().condExpr())>()
+                + prefetch_stream_count<decltype(std::declval<const RawExpr&>().lhsExpr())>()
+                + prefetch_stream_count<decltype(std::declval<const RawExpr&>().rhsExpr())>();
+        } else {
+            return 0;
+        }
+    }
+
+    inline STEALTH_ALWAYS_INLINE void prefetch_line(const void* address) noexcept {
+        #ifdef __GNUC__
+            __builtin_prefetch(address);
+        #endif
+    }
+
+    // Distance in elements of a destination with the given scalar type.
+    template <typename ScalarType>
+    constexpr int prefetch_distance() noexcept {
+        return kPREFETCH_DISTANCE_BYTES / static_cast<int>(sizeof(ScalarType));
+    }
+
+    template <typename Expr>
+    constexpr STEALTH_ALWAYS_INLINE void prefetch_leaves(const Expr& expr, int x, int y, int z, int count) noexcept;
+
+    // Operands that are broadcast along an axis are read at coordinate 0 of that axis.
+    template <typename Result, typename Operand>
+    constexpr STEALTH_ALWAYS_INLINE void prefetch_operand(const Operand& operand, int x, int y, int z, int count) noexcept {
+        using RawOperand = raw_type<Operand>;
+        if constexpr (prefetch_stream_count<RawOperand>() > 0) {
+            const bool broadcastX = traits<RawOperand>::width == 1 and traits<Result>::width != 1;
+            prefetch_leaves(operand, broadcastX ? 0 : x, traits<RawOperand>::length == 1 ? 0 : y,
+                traits<RawOperand>::height == 1 ? 0 : z, broadcastX ? 1 : count);
+        }
+    }
+
+    // Prefetches count elements along x, starting at (x, y, z), from every leaf stream of expr.
+    template <typename Expr>
+    constexpr STEALTH_ALWAYS_INLINE void prefetch_leaves(const Expr& expr, int x, int y, int z, int count) noexcept {
+        using RawExpr = raw_type<Expr>;
+        constexpr ExpressionType exprType = traits<RawExpr>::exprType;
+        if constexpr (kPREFETCH_DISTANCE_BYTES <= 0) {
+            return;
+        } else if constexpr (exprType == ExpressionType::Tensor3 or exprType == ExpressionType::TrackedTensor3) {
+            using Index = typename traits<RawExpr>::IndexType;
+            const Index index = x + Index{y} * traits<RawExpr>::width + Index{z} * traits<RawExpr>::area;
+            if (index < 0 or index >= traits<RawExpr>::size) return;
+            const char* first = reinterpret_cast<const char*>(&expr(index));
+            const int numBytes = static_cast<int>(std::min<long long>(count, traits<RawExpr>::size - index))
+                * static_cast<int>(sizeof(typename traits<RawExpr>::ScalarType));
+            for (int offset = 0; offset < numBytes; offset += kCACHE_LINE_BYTES) {
+                prefetch_line(first + offset);
+            }
+        } else if constexpr (exprType == ExpressionType::BlockExpr) {
+            const auto offsets = expr.offsets();
+            prefetch_leaves(expr.underlyingTensor3(), x + offsets[0], y + offsets[1], z + offsets[2], count);
+        } else if constexpr (exprType == ExpressionType::ElemWiseUnaryExpr) {
+            prefetch_operand<RawExpr>(expr.lhsExpr(), x, y, z, count);
+        } else if constexpr (exprType == ExpressionType::ElemWiseBinaryExpr) {
+            prefetch_operand<RawExpr>(expr.lhsExpr(), x, y, z, count);
+            prefetch_operand<RawExpr>(expr.rhsExpr(), x, y, z, count);
+        } else if constexpr (exprType == ExpressionType::SelectExpr) {
+            prefetch_operand<RawExpr>(expr.condExpr(), x, y, z, count);
+            prefetch_operand<RawExpr>(expr.lhsExpr(), x, y, z, count);
+            prefetch_operand<RawExpr>(expr.rhsExpr(), x, y, z, count);
+        }
+    }
+
+    // As above, for the element at a flat index of expr.
+    template <typename Expr, typename Index>
+    constexpr STEALTH_ALWAYS_INLINE void prefetch_flat(const Expr& expr, Index index, int count) noexcept {
+        using RawExpr = raw_type<Expr>;
+        if (index >= traits<RawExpr>::size) return;
+        prefetch_leaves(expr, static_cast<int>(index % traits<RawExpr>::width),
+            static_cast<int>((index / traits<RawExpr>::width) % traits<RawExpr>::length),
+            static_cast<int>(index / traits<RawExpr>::area), count);
+    }
+} /* Stealth::Tensor::internal */
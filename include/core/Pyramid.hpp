@@ -0,0 +1,132 @@
+#pragma once
+#include "ForwardDeclarations.hpp"
+#include "Tensor3.hpp"
+#include "../Expressions/PoolExpr.hpp"
+#include "../Expressions/ReshapeExpr.hpp"
+#include "../Executors/CpuDispatch.hpp"
+#include "../Executors/Executor.hpp"
+#include <algorithm>
+
+namespace Stealth::Tensor {
+    namespace internal {
+        template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime>
+        constexpr int pyramid_level_size(int level) noexcept {
+            return (widthAtCompileTime >> level) * (lengthAtCompileTime >> level) * heightAtCompileTime;
+        }
+
+        // Levels are stored back to back, starting at level 1.
+        template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime>
+        constexpr int pyramid_level_offset(int level) noexcept {
+            int offset = 0;
+            for (int i = 1; i < level; ++i) {
+                offset += pyramid_level_size<widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>(i);
+            }
+            return offset;
+        }
+    } /* internal */
+
+    // Level k is the base downsampled by 2^k in x and y. The base itself (level 0) is not stored.
+    template <typename ScalarType, int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime,
+        int numLevels, PoolingMode mode>
+    class Pyramid {
+        static_assert(numLevels > 0 and (widthAtCompileTime >> numLevels) > 0 and (lengthAtCompileTime >> numLevels) > 0,
+            "Pyramid has more levels than the base can be downsampled");
+
+        static constexpr int kTOTAL_SIZE = internal::pyramid_level_offset<widthAtCompileTime, lengthAtCompileTime,
+            heightAtCompileTime>(numLevels + 1);
+
+        public:
+            constexpr STEALTH_ALWAYS_INLINE Pyramid() noexcept { }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE Pyramid(const OtherTensor3& base) {
+                build(base);
+            }
+
+            static constexpr STEALTH_ALWAYS_INLINE int levels() noexcept {
+                return numLevels;
+            }
+
+            template <int levelNum>
+            constexpr STEALTH_ALWAYS_INLINE auto level() noexcept {
+                static_assert(levelNum > 0 and levelNum <= numLevels, "Pyramid level out of range");
+                return ReshapeExpr<(widthAtCompileTime >> levelNum), (lengthAtCompileTime >> levelNum),
+                    heightAtCompileTime, decltype(mData)&>{mData, levelOffset(levelNum)};
+            }
+
+            template <int levelNum>
+            constexpr STEALTH_ALWAYS_INLINE auto level() const noexcept {
+                static_assert(levelNum > 0 and levelNum <= numLevels, "Pyramid level out of range");
+                return ReshapeExpr<(widthAtCompileTime >> levelNum), (lengthAtCompileTime >> levelNum),
+                    heightAtCompileTime, const decltype(mData)&>{mData, levelOffset(levelNum)};
+            }
+
+            // Rebuilds every level. Bands of base rows are carried through all levels before moving on,
+            // so each band's inputs are still in cache when the next level reads them.
+            template <typename OtherTensor3>
+            constexpr void build(const OtherTensor3& base) {
+                static_assert(internal::traits<OtherTensor3>::width == widthAtCompileTime
+                    and internal::traits<OtherTensor3>::length == lengthAtCompileTime
+                    and internal::traits<OtherTensor3>::height == heightAtCompileTime,
+                    "Cannot build Pyramid from incompatible Tensor3");
+                // Each band covers one row of the coarsest level.
+                constexpr int numBands = lengthAtCompileTime >> numLevels;
+                constexpr int bandGrain = std::max(1, internal::kPARALLEL_GRAIN_SIZE / ((1 << numLevels) * widthAtCompileTime));
+                internal::parallel_for_dispatch(0, heightAtCompileTime * numBands, bandGrain, [this, &base](int begin, int end) {
+                    for (int index = begin; index < end; ++index) {
+                        const int z = index / numBands, band = index % numBands;
+                        for (int level = 1; level <= numLevels; ++level) {
+                            const int bandRows = 1 << (numLevels - level);
+                            buildRows(base, level, z, band * bandRows, (band + 1) * bandRows);
+                        }
+                    }
+                });
+                // Levels that were not an exact multiple of the band size have leftover rows.
+                internal::parallel_for_dispatch(0, heightAtCompileTime, 1, [this, &base](int begin, int end) {
+                    for (int z = begin; z < end; ++z) {
+                        for (int level = 1; level <= numLevels; ++level) {
+                            buildRows(base, level, z, numBands << (numLevels - level), lengthAtCompileTime >> level);
+                        }
+                    }
+                });
+            }
+
+        private:
+            Vector<ScalarType, kTOTAL_SIZE> mData;
+
+            static constexpr STEALTH_ALWAYS_INLINE int levelOffset(int level) noexcept {
+                return internal::pyramid_level_offset<widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>(level);
+            }
+
+            using Accumulator = internal::pool_accumulator<mode, ScalarType>;
+
+            // Combines the 2x2 window at (x, y, z) of the previous level, in a type wide enough not to overflow.
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE Accumulator window(const OtherTensor3& base, int level, int x, int y, int z) const {
+                if (level == 1) {
+                    Accumulator accumulated = static_cast<ScalarType>(base(x, y, z));
+                    accumulated = internal::pool_combine<mode, Accumulator>(accumulated, static_cast<ScalarType>(base(x + 1, y, z)));
+                    accumulated = internal::pool_combine<mode, Accumulator>(accumulated, static_cast<ScalarType>(base(x, y + 1, z)));
+                    return internal::pool_combine<mode, Accumulator>(accumulated, static_cast<ScalarType>(base(x + 1, y + 1, z)));
+                }
+                const int width = widthAtCompileTime >> (level - 1), length = lengthAtCompileTime >> (level - 1);
+                const int index = levelOffset(level - 1) + x + y * width + z * width * length;
+                Accumulator accumulated = mData(index);
+                accumulated = internal::pool_combine<mode, Accumulator>(accumulated, mData(index + 1));
+                accumulated = internal::pool_combine<mode, Accumulator>(accumulated, mData(index + width));
+                return internal::pool_combine<mode, Accumulator>(accumulated, mData(index + width + 1));
+            }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void buildRows(const OtherTensor3& base, int level, int z, int minY, int maxY) {
+                const int width = widthAtCompileTime >> level, length = lengthAtCompileTime >> level;
+                ScalarType* out = mData.data() + levelOffset(level) + z * width * length;
+                for (int y = minY; y < maxY; ++y) {
+                    #pragma omp simd
+                    for (int x = 0; x < width; ++x) {
+                        out[x + y * width] = internal::pool_finalize<mode, 4, ScalarType>(window(base, level, x * 2, y * 2, z));
+                    }
+                }
+            }
+    };
+} /* Stealth::Tensor */
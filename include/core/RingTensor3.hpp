@@ -0,0 +1,190 @@
+#pragma once
+#include "ForwardDeclarations.hpp"
+#include "Tensor3.hpp"
+#include "../Executors/Executor.hpp"
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+namespace Stealth::Tensor {
+    namespace internal {
+        template <typename type, int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime>
+        struct traits<RingTensor3<type, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>>
+            : traits<Tensor3<type, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>> {
+            static constexpr ExpressionType exprType = ExpressionType::RingTensor3;
+            // Logical coordinates wrap around in storage, so rows are never contiguous as a whole.
+            static constexpr int indexingMode = 3;
+        };
+
+        // Maps a coordinate in [0, extent) shifted by an origin in [0, extent) back into [0, extent).
+        constexpr STEALTH_ALWAYS_INLINE int wrap(int coordinate, int extent) noexcept {
+            return coordinate - (coordinate >= extent ? extent : 0);
+        }
+
+        // Positive modulo, for origins that move by arbitrary amounts.
+        constexpr STEALTH_ALWAYS_INLINE int wrap_origin(int origin, int extent) noexcept {
+            const int wrapped = origin % extent;
+            return wrapped < 0 ? wrapped + extent : wrapped;
+        }
+    } /* internal */
+
+    // Toroidal buffer for scrolling maps. Logical coordinates are relative to a movable origin, so scrolling is
+    // O(1) and leaves every element that stays in view where it is; only the edge that scrolls into view holds
+    // stale data and needs refilling. Within a region every row is at most two contiguous runs of storage,
+    // which the kernels here evaluate separately so that they remain vectorized.
+    template <typename ScalarType, int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime>
+    class RingTensor3 : public Tensor3Base<RingTensor3<ScalarType, widthAtCompileTime, lengthAtCompileTime,
+        heightAtCompileTime>> {
+        public:
+            using TensorType = Tensor3<ScalarType, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>;
+
+            constexpr STEALTH_ALWAYS_INLINE RingTensor3() noexcept { }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE RingTensor3(const OtherTensor3& other) : mTensor3{kUNINITIALIZED} {
+                fill(kWHOLE, other);
+            }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE RingTensor3& operator=(const OtherTensor3& other) {
+                fill(kWHOLE, other);
+                return *this;
+            }
+
+            // Accessors take logical coordinates.
+            constexpr STEALTH_ALWAYS_INLINE auto& operator()(int x, int y, int z) {
+                return mTensor3(internal::wrap(x + mOriginX, widthAtCompileTime), internal::wrap(y + mOriginY, lengthAtCompileTime),
+                    internal::wrap(z + mOriginZ, heightAtCompileTime));
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& operator()(int x, int y, int z) const {
+                return mTensor3(internal::wrap(x + mOriginX, widthAtCompileTime), internal::wrap(y + mOriginY, lengthAtCompileTime),
+                    internal::wrap(z + mOriginZ, heightAtCompileTime));
+            }
+
+            // The lower dimensional accessors fold the remaining axes into the last one.
+            constexpr STEALTH_ALWAYS_INLINE auto& operator()(int x, int y) {
+                return (*this)(x, y % lengthAtCompileTime, y / lengthAtCompileTime);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& operator()(int x, int y) const {
+                return (*this)(x, y % lengthAtCompileTime, y / lengthAtCompileTime);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto& operator()(int x) {
+                return (*this)(x % widthAtCompileTime, x / widthAtCompileTime);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& operator()(int x) const {
+                return (*this)(x % widthAtCompileTime, x / widthAtCompileTime);
+            }
+
+            // Moves the view by (dx, dy, dz), so that what was at (x + dx, y + dy, z + dz) is now at (x, y, z).
+            // Returns the disjoint regions that scrolled into view, in logical coordinates.
+            constexpr std::array<Region, 3> scroll(int dx, int dy, int dz = 0) noexcept {
+                mOriginX = internal::wrap_origin(mOriginX + dx, widthAtCompileTime);
+                mOriginY = internal::wrap_origin(mOriginY + dy, lengthAtCompileTime);
+                mOriginZ = internal::wrap_origin(mOriginZ + dz, heightAtCompileTime);
+                // Each slab excludes whatever the slabs before it already cover.
+                const std::array<int, 2> keptX = kept_range(dx, widthAtCompileTime),
+                    keptY = kept_range(dy, lengthAtCompileTime);
+                return {
+                    exposed_range(dx, widthAtCompileTime, 0, lengthAtCompileTime, 0, heightAtCompileTime, 0),
+                    exposed_range(dy, lengthAtCompileTime, keptX[0], keptX[1], 0, heightAtCompileTime, 1),
+                    exposed_range(dz, heightAtCompileTime, keptX[0], keptX[1], keptY[0], keptY[1], 2)
+                };
+            }
+
+            // Scrolls, then refills the newly exposed edge from source, which is read at logical coordinates.
+            template <typename Source>
+            constexpr void scroll(int dx, int dy, int dz, const Source& source) {
+                const std::array<Region, 3> exposed = scroll(dx, dy, dz);
+                for (int i = 0; i < 3; ++i) fill(exposed[i], source);
+            }
+
+            // Writes source(x, y, z), or a scalar, to every logical (x, y, z) in region.
+            template <typename Source>
+            constexpr void fill(const Region& region, const Source& source) {
+                if (region.empty()) return;
+                const int regionLength = region.maxY - region.minY;
+                internal::parallel_for(0, regionLength * (region.maxZ - region.minZ), internal::row_grain(region.maxX - region.minX),
+                    [this, &region, &source, regionLength](int begin, int end) {
+                        for (int row = begin; row < end; ++row) {
+                            const int y = region.minY + row % regionLength, z = region.minZ + row / regionLength;
+                            ScalarType* storageRow = &mTensor3(0, internal::wrap(y + mOriginY, lengthAtCompileTime),
+                                internal::wrap(z + mOriginZ, heightAtCompileTime));
+                            for_each_segment(region.minX, region.maxX, [&source, storageRow, y, z](int shift, int minX, int maxX) {
+                                #pragma omp simd
+                                for (int x = minX; x < maxX; ++x) {
+                                    if constexpr (std::is_scalar<Source>::value) storageRow[x + shift] = source;
+                                    else storageRow[x + shift] = source(x, y, z);
+                                }
+                            });
+                        }
+                    });
+            }
+
+            // Unwraps into dest, e.g. a Tensor3 assigned from this, in logical order.
+            template <typename Dest>
+            constexpr void copyTo(Dest& dest) const {
+                internal::parallel_for(0, lengthAtCompileTime * heightAtCompileTime, internal::row_grain(widthAtCompileTime),
+                    [this, &dest](int begin, int end) {
+                        for (int row = begin; row < end; ++row) {
+                            const int y = row % lengthAtCompileTime, z = row / lengthAtCompileTime;
+                            const ScalarType* storageRow = &mTensor3(0, internal::wrap(y + mOriginY, lengthAtCompileTime),
+                                internal::wrap(z + mOriginZ, heightAtCompileTime));
+                            for_each_segment(0, widthAtCompileTime, [&dest, storageRow, y, z](int shift, int minX, int maxX) {
+                                #pragma omp simd
+                                for (int x = minX; x < maxX; ++x) {
+                                    dest(x, y, z) = storageRow[x + shift];
+                                }
+                            });
+                        }
+                    });
+            }
+
+            // Where logical (0, 0, 0) lives in storage.
+            constexpr STEALTH_ALWAYS_INLINE std::array<int, 3> origin() const noexcept {
+                return {mOriginX, mOriginY, mOriginZ};
+            }
+
+            // Storage, in which logical coordinates are rotated by the origin.
+            constexpr STEALTH_ALWAYS_INLINE const TensorType& storage() const noexcept {
+                return mTensor3;
+            }
+        private:
+            static constexpr Region kWHOLE{0, 0, 0, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime};
+
+            // Splits the logical range [minX, maxX) of a row into the runs that are contiguous in storage, calling
+            // function(shift, begin, end) for each, where logical x is stored at column x + shift.
+            template <typename Function>
+            constexpr STEALTH_ALWAYS_INLINE void for_each_segment(int minX, int maxX, Function&& function) const {
+                // Logical x at which storage wraps back around to the start of the row.
+                const int split = std::clamp(widthAtCompileTime - mOriginX, minX, maxX);
+                if (minX < split) function(mOriginX, minX, split);
+                if (split < maxX) function(mOriginX - widthAtCompileTime, split, maxX);
+            }
+
+            // Logical range along an axis that is still valid after scrolling by delta.
+            static constexpr std::array<int, 2> kept_range(int delta, int extent) noexcept {
+                if (delta >= extent or delta <= -extent) return {0, 0};
+                return delta >= 0 ? std::array<int, 2>{0, extent - delta} : std::array<int, 2>{-delta, extent};
+            }
+
+            // The part of the tensor outside the kept range along axis, limited to the given ranges on the other axes.
+            static constexpr Region exposed_range(int delta, int extent, int minA, int maxA, int minB, int maxB, int axis) noexcept {
+                const std::array<int, 2> kept = kept_range(delta, extent);
+                // Exposed elements are on the opposite side of the kept range.
+                int minExposed = 0, maxExposed = 0;
+                if (kept[0] == kept[1]) maxExposed = extent;
+                else if (delta > 0) { minExposed = kept[1]; maxExposed = extent; }
+                else if (delta < 0) { maxExposed = kept[0]; }
+                if (axis == 0) return Region{minExposed, minA, minB, maxExposed, maxA, maxB};
+                if (axis == 1) return Region{minA, minExposed, minB, maxA, maxExposed, maxB};
+                return Region{minA, minB, minExposed, maxA, maxB, maxExposed};
+            }
+
+            TensorType mTensor3{};
+            int mOriginX = 0, mOriginY = 0, mOriginZ = 0;
+    };
+} /* Stealth::Tensor */
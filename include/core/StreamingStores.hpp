@@ -0,0 +1,70 @@
+#pragma once
+#include "ForwardDeclarations.hpp"
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#if defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+namespace Stealth::Tensor::internal {
+    // Destinations at least this large are assumed not to fit in the last level cache.
+    constexpr long long kSTREAMING_THRESHOLD_BYTES = 32ll << 20;
+    constexpr int kCACHE_LINE_BYTES = 64;
+
+    template <typename ScalarType>
+    constexpr bool supports_streaming() noexcept {
+        return std::is_trivially_copyable<ScalarType>::value and kCACHE_LINE_BYTES % sizeof(ScalarType) == 0;
+    }
+
+    template <StorePolicy policy, typename ScalarType, long long sizeAtCompileTime>
+    constexpr bool use_streaming() noexcept {
+        if constexpr (!supports_streaming<ScalarType>() or policy == StorePolicy::Cached) return false;
+        else if constexpr (policy == StorePolicy::Streaming) return true;
+        else return static_cast<long long>(sizeAtCompileTime) * sizeof(ScalarType) >= kSTREAMING_THRESHOLD_BYTES;
+    }
+
+    // Writes a full cache line without first reading it into the cache. dest must be line-aligned.
+    inline void stream_line(void* dest, const void* line) noexcept {
+        #if defined(__AVX__)
+            _mm256_stream_si256(static_cast<__m256i*>(dest), _mm256_load_si256(static_cast<const __m256i*>(line)));
+            _mm256_stream_si256(static_cast<__m256i*>(dest) + 1, _mm256_load_si256(static_cast<const __m256i*>(line) + 1));
+        #elif defined(__SSE2__)
+            for (int i = 0; i < kCACHE_LINE_BYTES / 16; ++i) {
+                _mm_stream_si128(static_cast<__m128i*>(dest) + i, _mm_load_si128(static_cast<const __m128i*>(line) + i));
+            }
+        #else
+            std::memcpy(dest, line, kCACHE_LINE_BYTES);
+        #endif
+    }
+
+    // Non-temporal stores are weakly ordered. Every thread that streamed must fence before its
+    // results can be relied upon by another thread.
+    inline void stream_fence() noexcept {
+        #if defined(__SSE2__)
+            _mm_sfence();
+        #endif
+    }
+
+    // Writes value(i) to dest[i] for i in [begin, end). Whole cache lines are evaluated into a
+    // local buffer and streamed out; the unaligned head and tail use ordinary stores.
+    template <typename ScalarType, typename Index, typename ValueFunction>
+    inline void stream_range(ScalarType* dest, Index begin, Index end, const ValueFunction& value) {
+        constexpr int lineSize = kCACHE_LINE_BYTES / sizeof(ScalarType);
+        Index i = begin;
+        for (; i < end and reinterpret_cast<std::uintptr_t>(dest + i) % kCACHE_LINE_BYTES != 0; ++i) {
+            dest[i] = value(i);
+        }
+        for (; i + lineSize <= end; i += lineSize) {
+            alignas(kCACHE_LINE_BYTES) ScalarType line[lineSize];
+            #pragma omp simd
+            for (int k = 0; k < lineSize; ++k) {
+                line[k] = value(i + k);
+            }
+            stream_line(dest + i, line);
+        }
+        for (; i < end; ++i) {
+            dest[i] = value(i);
+        }
+    }
+} /* Stealth::Tensor::internal */
@@ -0,0 +1,59 @@
+#pragma once
+#include "ForwardDeclarations.hpp"
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Stealth::Tensor {
+    // Interns strings so that tiles can store a StringHandle instead. Equal strings always get the
+    // same handle, so string comparisons over a whole map become integer comparisons. Handle 0 is
+    // the empty string, which makes zero-initialized handle planes read as empty.
+    // Interning is not thread-safe; lookups of existing handles are.
+    class StringPool {
+        public:
+            static constexpr StringHandle kEMPTY = 0;
+            static constexpr StringHandle kNOT_FOUND = -1;
+
+            StringPool() {
+                intern(std::string_view{});
+            }
+
+            // Strings are referred to by views into mStrings, so the pool cannot be copied or moved.
+            StringPool(const StringPool&) = delete;
+            StringPool& operator=(const StringPool&) = delete;
+
+            StringHandle intern(std::string_view str) {
+                const auto existing = mHandles.find(str);
+                if (existing != mHandles.end()) return existing -> second;
+                const StringHandle handle = static_cast<StringHandle>(mStrings.size());
+                // A deque never relocates its elements, so views into them stay valid.
+                const std::string& stored = mStrings.emplace_back(str);
+                mHandles.emplace(std::string_view{stored}, handle);
+                return handle;
+            }
+
+            // Returns kNOT_FOUND for strings that were never interned.
+            StringHandle find(std::string_view str) const noexcept {
+                const auto existing = mHandles.find(str);
+                return existing == mHandles.end() ? kNOT_FOUND : existing -> second;
+            }
+
+            const std::string& operator[](StringHandle handle) const noexcept {
+                return mStrings[handle];
+            }
+
+            const std::string& at(StringHandle handle) const {
+                if (handle < 0 or handle >= size()) throw std::out_of_range("Invalid StringHandle");
+                return mStrings[handle];
+            }
+
+            int size() const noexcept {
+                return static_cast<int>(mStrings.size());
+            }
+        private:
+            std::deque<std::string> mStrings;
+            std::unordered_map<std::string_view, StringHandle> mHandles;
+    };
+} /* Stealth::Tensor */
@@ -0,0 +1,154 @@
+#pragma once
+#include "ForwardDeclarations.hpp"
+#include "Tensor3.hpp"
+#include "../Executors/CpuDispatch.hpp"
+#include "../Executors/Executor.hpp"
+#include <algorithm>
+
+namespace Stealth::Tensor {
+    // The table is padded with a zero plane on the low side of each axis, so that
+    // entry (x + 1, y + 1, z + 1) holds the sum of everything up to and including (x, y, z).
+    template <typename ScalarType, int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime>
+    class SummedAreaTable {
+        public:
+            constexpr STEALTH_ALWAYS_INLINE SummedAreaTable() noexcept { }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE SummedAreaTable(const OtherTensor3& source) {
+                build(source);
+            }
+
+            static constexpr STEALTH_ALWAYS_INLINE auto width() noexcept {
+                return widthAtCompileTime;
+            }
+
+            static constexpr STEALTH_ALWAYS_INLINE auto length() noexcept {
+                return lengthAtCompileTime;
+            }
+
+            static constexpr STEALTH_ALWAYS_INLINE auto height() noexcept {
+                return heightAtCompileTime;
+            }
+
+            // Sum over the half-open box [x0, x1) x [y0, y1) x [z0, z1).
+            constexpr STEALTH_ALWAYS_INLINE ScalarType regionSum(int x0, int y0, int z0, int x1, int y1, int z1) const {
+                return mTable(x1, y1, z1) - mTable(x0, y1, z1) - mTable(x1, y0, z1) - mTable(x1, y1, z0)
+                    + mTable(x0, y0, z1) + mTable(x0, y1, z0) + mTable(x1, y0, z0) - mTable(x0, y0, z0);
+            }
+
+            // Sum over the half-open rectangle [x0, x1) x [y0, y1) across all layers.
+            constexpr STEALTH_ALWAYS_INLINE ScalarType regionSum(int x0, int y0, int x1, int y1) const {
+                return regionSum(x0, y0, 0, x1, y1, heightAtCompileTime);
+            }
+
+            template <typename OtherTensor3>
+            constexpr void build(const OtherTensor3& source) {
+                assert_source_compatibility<OtherTensor3>();
+                clear_padding();
+                // Prefix sums along x - every row is independent.
+                internal::parallel_for_dispatch(0, lengthAtCompileTime * heightAtCompileTime, internal::row_grain(widthAtCompileTime),
+                    [this, &source](int begin, int end) {
+                        for (int row = begin; row < end; ++row) {
+                            const int y = row % lengthAtCompileTime, z = row / lengthAtCompileTime;
+                            ScalarType accumulated{};
+                            for (int x = 0; x < widthAtCompileTime; ++x) {
+                                accumulated += static_cast<ScalarType>(source(x, y, z));
+                                mTable(x + 1, y + 1, z + 1) = accumulated;
+                            }
+                        }
+                    });
+                // Prefix sums along y - layers are independent and each row is a vector add.
+                constexpr int layerGrain = std::max(1, internal::kPARALLEL_GRAIN_SIZE / (widthAtCompileTime * lengthAtCompileTime));
+                internal::parallel_for_dispatch(1, heightAtCompileTime + 1, layerGrain, [this](int begin, int end) {
+                    for (int z = begin; z < end; ++z) {
+                        for (int y = 2; y <= lengthAtCompileTime; ++y) {
+                            #pragma omp simd
+                            for (int x = 1; x <= widthAtCompileTime; ++x) {
+                                mTable(x, y, z) += mTable(x, y - 1, z);
+                            }
+                        }
+                    }
+                });
+                // Prefix sums along z - rows are independent.
+                for (int z = 2; z <= heightAtCompileTime; ++z) {
+                    internal::parallel_for_dispatch(1, lengthAtCompileTime + 1, internal::row_grain(widthAtCompileTime),
+                        [this, z](int begin, int end) {
+                            for (int y = begin; y < end; ++y) {
+                                #pragma omp simd
+                                for (int x = 1; x <= widthAtCompileTime; ++x) {
+                                    mTable(x, y, z) += mTable(x, y, z - 1);
+                                }
+                            }
+                        });
+                }
+            }
+
+            // Rebuilds after source changed only in rows minY and above of layers minZ and above.
+            // Everything before that is reused.
+            template <typename OtherTensor3>
+            constexpr void update(const OtherTensor3& source, int minY, int minZ = 0) {
+                assert_source_compatibility<OtherTensor3>();
+                const int columnGrain = std::max(1, internal::kPARALLEL_GRAIN_SIZE / std::max(1, lengthAtCompileTime - minY));
+                for (int z = minZ + 1; z <= heightAtCompileTime; ++z) {
+                    // Row prefix sums for the affected rows of this layer.
+                    internal::parallel_for_dispatch(minY + 1, lengthAtCompileTime + 1, internal::row_grain(widthAtCompileTime),
+                        [this, &source, z](int begin, int end) {
+                            for (int y = begin; y < end; ++y) {
+                                ScalarType accumulated{};
+                                for (int x = 1; x <= widthAtCompileTime; ++x) {
+                                    accumulated += static_cast<ScalarType>(source(x - 1, y - 1, z - 1));
+                                    mTable(x, y, z) = accumulated;
+                                }
+                            }
+                        });
+                    // The in-layer column sums of the last unaffected row can be recovered from the table,
+                    // since that row is unchanged in this and all previous layers.
+                    internal::parallel_for_dispatch(1, widthAtCompileTime + 1, columnGrain, [this, minY, z](int begin, int end) {
+                        for (int x = begin; x < end; ++x) {
+                            ScalarType column = mTable(x, minY, z) - mTable(x, minY, z - 1);
+                            for (int y = minY + 1; y <= lengthAtCompileTime; ++y) {
+                                column += mTable(x, y, z);
+                                mTable(x, y, z) = column + mTable(x, y, z - 1);
+                            }
+                        }
+                    });
+                }
+            }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void updateLayers(const OtherTensor3& source, int minZ) {
+                update(source, 0, minZ);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& table() const noexcept {
+                return mTable;
+            }
+
+        private:
+            Tensor3<ScalarType, widthAtCompileTime + 1, lengthAtCompileTime + 1, heightAtCompileTime + 1> mTable;
+
+            constexpr STEALTH_ALWAYS_INLINE void clear_padding() {
+                for (int z = 0; z <= heightAtCompileTime; ++z) {
+                    for (int y = 0; y <= lengthAtCompileTime; ++y) {
+                        mTable(0, y, z) = ScalarType{};
+                    }
+                    for (int x = 0; x <= widthAtCompileTime; ++x) {
+                        mTable(x, 0, z) = ScalarType{};
+                    }
+                }
+                for (int y = 0; y <= lengthAtCompileTime; ++y) {
+                    for (int x = 0; x <= widthAtCompileTime; ++x) {
+                        mTable(x, y, 0) = ScalarType{};
+                    }
+                }
+            }
+
+            template <typename OtherTensor3>
+            static constexpr STEALTH_ALWAYS_INLINE void assert_source_compatibility() noexcept {
+                static_assert(internal::traits<OtherTensor3>::width == widthAtCompileTime
+                    and internal::traits<OtherTensor3>::length == lengthAtCompileTime
+                    and internal::traits<OtherTensor3>::height == heightAtCompileTime,
+                    "Cannot build SummedAreaTable from incompatible Tensor3");
+            }
+    };
+} /* Stealth::Tensor */
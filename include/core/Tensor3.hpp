@@ -2,7 +2,14 @@
 #include "ForwardDeclarations.hpp"
 #include "Tensor3Base.hpp"
 #include "DenseStorage.hpp"
+#include "Layout.hpp"
+#include "StreamingStores.hpp"
+#include "Prefetch.hpp"
+#include "../Executors/CpuDispatch.hpp"
+#include "../Executors/Executor.hpp"
 #include "../Operations/ElemWiseBinaryOps.hpp"
+#include <limits>
+#include <type_traits>
 
 #ifdef DEBUG
     #include <iostream>
@@ -10,17 +17,27 @@
 
 namespace Stealth::Tensor {
     namespace internal {
+        // Number of elements checked together when deciding whether a select can skip one of its operands.
+        constexpr int kSELECT_BLOCK_SIZE = 64;
+
         template <typename type, int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime,
-            int areaAtCompileTime, int sizeAtCompileTime>
-        struct traits<Tensor3<type, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime, areaAtCompileTime, sizeAtCompileTime>> {
+            typename Layout, long long areaAtCompileTime, long long sizeAtCompileTime>
+        struct traits<Tensor3<type, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime, Layout, areaAtCompileTime,
+            sizeAtCompileTime>> {
             static constexpr ExpressionType exprType = ExpressionType::Tensor3;
             using ScalarType = type;
+            using LayoutType = Layout;
+            using IndexType = index_type<Layout::template kSTORAGE_SIZE<widthAtCompileTime, lengthAtCompileTime,
+                heightAtCompileTime>>;
+            // Flat and row indices only line up with coordinates in row-major storage, so expressions that read
+            // any other layout fall back to 3D indexing. Tensors too large for int flat indices are evaluated
+            // by rows, so that int loop counters never overflow.
             static constexpr int width = widthAtCompileTime,
                 length = lengthAtCompileTime,
                 height = heightAtCompileTime,
-                area = areaAtCompileTime,
-                size = sizeAtCompileTime,
-                indexingMode = 1;
+                indexingMode = is_row_major<Layout> ? (std::is_same<IndexType, int>::value ? 1 : 2) : 3;
+            static constexpr long long area = areaAtCompileTime,
+                size = sizeAtCompileTime;
             static constexpr bool is_scalar = size == 1;
             static constexpr bool is_vector = !is_scalar and (width == size or length == size or height == size);
             static constexpr bool is_matrix = !is_vector and (width == 1 or length == 1 or height == 1);
@@ -28,12 +45,24 @@ namespace Stealth::Tensor {
     } /* internal */
 
     template <typename ScalarType, int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime,
-        int areaAtCompileTime, int sizeAtCompileTime>
+        typename Layout, long long areaAtCompileTime, long long sizeAtCompileTime>
     class Tensor3 : public Tensor3Base<Tensor3<ScalarType, widthAtCompileTime, lengthAtCompileTime,
-        heightAtCompileTime, areaAtCompileTime, sizeAtCompileTime>> {
+        heightAtCompileTime, Layout, areaAtCompileTime, sizeAtCompileTime>> {
+        // Padded out to whole bricks for tiled layouts.
+        static constexpr long long kSTORAGE_SIZE = Layout::template kSTORAGE_SIZE<widthAtCompileTime, lengthAtCompileTime,
+            heightAtCompileTime>;
+        static_assert(static_cast<long long>(lengthAtCompileTime) * heightAtCompileTime <= std::numeric_limits<int>::max(),
+            "Rows of a Tensor3 must be countable by int");
+
         public:
+            // int, unless the tensor has more elements than int can count.
+            using IndexType = typename internal::traits<Tensor3>::IndexType;
+
             constexpr STEALTH_ALWAYS_INLINE Tensor3() noexcept { }
 
+            // Skips initialization entirely. Every element must be written before it is read.
+            explicit STEALTH_ALWAYS_INLINE Tensor3(Uninitialized) : mData{kUNINITIALIZED} { }
+
             constexpr STEALTH_ALWAYS_INLINE Tensor3(const std::initializer_list<ScalarType>& other) {
                 assign_initializer_list_impl(other);
             }
@@ -45,12 +74,11 @@ namespace Stealth::Tensor {
             }
 
             // Copy Constructors
-            constexpr STEALTH_ALWAYS_INLINE Tensor3(const Tensor3& other) noexcept {
-                mData = other.elements();
-            }
+            constexpr STEALTH_ALWAYS_INLINE Tensor3(const Tensor3& other) noexcept : mData{other.elements()} { }
 
+            // Every element is about to be written, so there is no need to zero the storage first.
             template <typename OtherTensor3>
-            constexpr STEALTH_ALWAYS_INLINE Tensor3(OtherTensor3&& other) noexcept {
+            constexpr STEALTH_ALWAYS_INLINE Tensor3(OtherTensor3&& other) noexcept : mData{kUNINITIALIZED} {
                 copy(std::forward<OtherTensor3&&>(other));
             }
 
@@ -66,13 +94,21 @@ namespace Stealth::Tensor {
                 return *this;
             }
 
+            // Assignment with an explicit store policy, e.g. to force streaming stores into a destination
+            // whose results will not be read again soon, or to keep a large destination in cache.
+            template <StorePolicy policy, typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE Tensor3& assign(OtherTensor3&& other) {
+                copy<policy>(std::forward<OtherTensor3&&>(other));
+                return *this;
+            }
+
             // Move Constructors
-            constexpr STEALTH_ALWAYS_INLINE Tensor3(Tensor3&& other) noexcept {
+            constexpr STEALTH_ALWAYS_INLINE Tensor3(Tensor3&& other) noexcept : mData{kUNINITIALIZED} {
                 this -> move(other);
             }
 
             template <int width, int length, int height>
-            constexpr STEALTH_ALWAYS_INLINE Tensor3(Tensor3<ScalarType, width, length, height>&& other) {
+            constexpr STEALTH_ALWAYS_INLINE Tensor3(Tensor3<ScalarType, width, length, height, Layout>&& other) : mData{kUNINITIALIZED} {
                 this -> move(other);
             }
 
@@ -83,33 +119,38 @@ namespace Stealth::Tensor {
             }
 
             template <typename OtherType, int width, int length, int height>
-            constexpr STEALTH_ALWAYS_INLINE Tensor3& operator=(Tensor3<OtherType, width, length, height>&& other) {
+            constexpr STEALTH_ALWAYS_INLINE Tensor3& operator=(Tensor3<OtherType, width, length, height, Layout>&& other) {
                 this -> move(other);
                 return *this;
             }
 
             // Accessors - conditionally multiply to save cycles for lower dimensional tensors.
             constexpr STEALTH_ALWAYS_INLINE auto& operator()(int x, int y, int z) {
-                return mData[x + (lengthAtCompileTime == 1 ? 0 : y * widthAtCompileTime) + (heightAtCompileTime == 1 ? 0 : z * areaAtCompileTime)];
+                return mData[Layout::template index<widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>(x, y, z)];
             }
 
             constexpr STEALTH_ALWAYS_INLINE const auto& operator()(int x, int y, int z) const {
-                return mData[x + (lengthAtCompileTime == 1 ? 0 : y * widthAtCompileTime) + (heightAtCompileTime == 1 ? 0 : z * areaAtCompileTime)];
+                return mData[Layout::template index<widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>(x, y, z)];
             }
 
+            // y spans the rows of every layer.
             constexpr STEALTH_ALWAYS_INLINE auto& operator()(int x, int y) {
-                return mData[x + (lengthAtCompileTime == 1 ? 0 : y * widthAtCompileTime)];
+                if constexpr (internal::is_row_major<Layout>) return mData[x + (lengthAtCompileTime == 1 ? 0 : IndexType{y} * widthAtCompileTime)];
+                else return (*this)(x, y % lengthAtCompileTime, y / lengthAtCompileTime);
             }
 
             constexpr STEALTH_ALWAYS_INLINE const auto& operator()(int x, int y) const {
-                return mData[x + (lengthAtCompileTime == 1 ? 0 : y * widthAtCompileTime)];
+                if constexpr (internal::is_row_major<Layout>) return mData[x + (lengthAtCompileTime == 1 ? 0 : IndexType{y} * widthAtCompileTime)];
+                else return (*this)(x, y % lengthAtCompileTime, y / lengthAtCompileTime);
             }
 
-            constexpr STEALTH_ALWAYS_INLINE auto& operator()(int x) {
+            // Indexes storage directly, which only follows x, then y, then z in row-major layouts.
+
+            constexpr STEALTH_ALWAYS_INLINE auto& operator()(IndexType x) {
                 return mData[x];
             }
 
-            constexpr STEALTH_ALWAYS_INLINE const auto& operator()(int x) const {
+            constexpr STEALTH_ALWAYS_INLINE const auto& operator()(IndexType x) const {
                 return mData[x];
             }
 
@@ -131,6 +172,8 @@ namespace Stealth::Tensor {
                 return mData;
             }
 
+            // Iterate over storage, which is only in x, then y, then z order in row-major layouts. Tiled layouts
+            // also include the padding that fills out their edge bricks.
             constexpr STEALTH_ALWAYS_INLINE auto begin() noexcept {
                 return mData.begin();
             }
@@ -170,59 +213,210 @@ namespace Stealth::Tensor {
                 return (*this);
             }
         private:
-            internal::DenseStorage<ScalarType, sizeAtCompileTime> mData;
+            internal::DenseStorage<ScalarType, kSTORAGE_SIZE> mData;
 
             template <typename T>
             constexpr STEALTH_ALWAYS_INLINE void assign_initializer_list_impl(const std::initializer_list<T>& other) {
                 if (other.size() > sizeAtCompileTime) {
                     throw std::invalid_argument("Cannot initialize Tensor3 from incompatible initializer list");
                 }
-                int index = 0;
+                // The list is in x, then y, then z order, which only storage order follows in row-major layouts.
+                IndexType index = 0;
                 for (auto& elem : other) {
-                    mData[index++] = elem;
+                    if constexpr (internal::is_row_major<Layout>) mData[index] = elem;
+                    else (*this)(static_cast<int>(index % widthAtCompileTime),
+                        static_cast<int>(index / widthAtCompileTime % lengthAtCompileTime),
+                        static_cast<int>(index / areaAtCompileTime)) = elem;
+                    ++index;
                 }
             }
 
+            template <StorePolicy policy>
             constexpr STEALTH_ALWAYS_INLINE void assign_scalar_impl(ScalarType scalar) {
                 // Assign the scalar value to every element.
-                for (int i = 0; i < Tensor3::size(); ++i) {
-                    (*this)(i) = scalar;
-                }
+                internal::parallel_for_flat_dispatch(IndexType{kSTORAGE_SIZE}, internal::kPARALLEL_GRAIN_SIZE, [this, scalar](IndexType begin, IndexType end) {
+                    if constexpr (use_streaming<policy>()) {
+                        internal::stream_range(mData.data(), begin, end, [scalar](IndexType) { return scalar; });
+                        internal::stream_fence();
+                    } else {
+                        #pragma omp simd
+                        for (IndexType i = begin; i < end; ++i) {
+                            (*this)(i) = scalar;
+                        }
+                    }
+                });
+            }
+
+            template <StorePolicy policy>
+            static constexpr bool use_streaming() noexcept {
+                return internal::use_streaming<policy, ScalarType, kSTORAGE_SIZE>();
+            }
+
+            // Also used for other layouts when every operand shares this one and the storage has no padding.
+            template <StorePolicy policy, typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void copy_impl_1D(const OtherTensor3& other) {
+                internal::parallel_for_flat_dispatch(IndexType{kSTORAGE_SIZE}, internal::kPARALLEL_GRAIN_SIZE, [this, &other](IndexType begin, IndexType end) {
+                    if constexpr (use_streaming<policy>()) {
+                        internal::stream_range(mData.data(), begin, end, [&other](IndexType i) { return other(i); });
+                        internal::stream_fence();
+                    } else if constexpr (internal::prefetch_stream_count<OtherTensor3>() >= internal::kPREFETCH_MIN_STREAMS) {
+                        constexpr int distance = internal::prefetch_distance<ScalarType>();
+                        for (IndexType chunkBegin = begin; chunkBegin < end; chunkBegin += internal::kPREFETCH_CHUNK_SIZE) {
+                            const IndexType chunkEnd = std::min(end, chunkBegin + internal::kPREFETCH_CHUNK_SIZE);
+                            internal::prefetch_flat(other, chunkBegin + distance, internal::kPREFETCH_CHUNK_SIZE);
+                            #pragma omp simd
+                            for (IndexType i = chunkBegin; i < chunkEnd; ++i) {
+                                (*this)(i) = other(i);
+                            }
+                        }
+                    } else {
+                        #pragma omp simd
+                        for (IndexType i = begin; i < end; ++i) {
+                            (*this)(i) = other(i);
+                        }
+                    }
+                });
             }
 
+            // Rows that are not contiguous with the previous one defeat the hardware prefetcher, so the start of
+            // the row a fixed distance ahead is prefetched from every stream.
             template <typename OtherTensor3>
-            constexpr STEALTH_ALWAYS_INLINE void copy_impl_1D(OtherTensor3&& other) {
-                #pragma omp parallel for simd
-                for (int i = 0; i < other.size(); ++i) {
-                    (*this)(i) = other(i);
+            constexpr STEALTH_ALWAYS_INLINE void prefetch_row(const OtherTensor3& other, int row) const noexcept {
+                if constexpr (internal::prefetch_stream_count<OtherTensor3>() > 0) {
+                    constexpr int width = internal::traits<OtherTensor3>::width,
+                        length = internal::traits<OtherTensor3>::length,
+                        height = internal::traits<OtherTensor3>::height;
+                    constexpr int distance = internal::prefetch_distance<ScalarType>();
+                    constexpr int rowsAhead = std::max(1, distance / width);
+                    const int aheadRow = row + rowsAhead;
+                    if (aheadRow < length * height) {
+                        internal::prefetch_leaves(other, 0, aheadRow % length, aheadRow / length, std::min(width, distance));
+                    }
                 }
             }
 
-            template <typename OtherTensor3>
-            constexpr STEALTH_ALWAYS_INLINE void copy_impl_2D(OtherTensor3&& other) {
-                #pragma omp parallel for simd
-                for (int j = 0; j < other.length() * other.height(); ++j) {
-                    for (int i = 0; i < other.width(); ++i) {
-                        (*this)(i + j * other.width()) = other(i, j);
+            template <StorePolicy policy, typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void copy_impl_2D(const OtherTensor3& other) {
+                internal::parallel_for_dispatch(0, other.length() * other.height(), internal::row_grain(other.width()),
+                    [this, &other](int begin, int end) {
+                        for (int j = begin; j < end; ++j) {
+                            prefetch_row(other, j);
+                            ScalarType* row = mData.data() + IndexType{j} * other.width();
+                            if constexpr (use_streaming<policy>()) {
+                                internal::stream_range(row, 0, other.width(), [&other, j](int i) { return other(i, j); });
+                            } else {
+                                #pragma omp simd
+                                for (int i = 0; i < other.width(); ++i) {
+                                    row[i] = other(i, j);
+                                }
+                            }
+                        }
+                        if constexpr (use_streaming<policy>()) internal::stream_fence();
+                    });
+            }
+
+            template <StorePolicy policy, typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void copy_impl_3D(const OtherTensor3& other) {
+                // Split over rows of all layers rather than layers alone so that thin tensors still parallelize.
+                internal::parallel_for_dispatch(0, other.length() * other.height(), internal::row_grain(other.width()),
+                    [this, &other](int begin, int end) {
+                        for (int row = begin; row < end; ++row) {
+                            const int j = row % other.length();
+                            const int z = row / other.length();
+                            prefetch_row(other, row);
+                            ScalarType* dest = mData.data() + IndexType{row} * other.width();
+                            if constexpr (use_streaming<policy>()) {
+                                internal::stream_range(dest, 0, other.width(), [&other, j, z](int i) { return other(i, j, z); });
+                            } else {
+                                #pragma omp simd
+                                for (int i = 0; i < other.width(); ++i) {
+                                    dest[i] = other(i, j, z);
+                                }
+                            }
+                        }
+                        if constexpr (use_streaming<policy>()) internal::stream_fence();
+                    });
+            }
+
+            // Walks the destination brick by brick, so that writes stay within a few cache lines and pages at a time.
+            // When every operand shares this layout, whole bricks are contiguous in both and are copied in storage
+            // order. Bricks on the edges are always copied by coordinates, so that padding is never evaluated.
+            template <bool inStorageOrder, typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void copy_impl_bricks(const OtherTensor3& other) {
+                constexpr int bricksPerLayer = Layout::template kBRICKS_PER_LAYER<widthAtCompileTime, lengthAtCompileTime>;
+                constexpr int brickWidth = internal::brick_size<Layout, widthAtCompileTime, lengthAtCompileTime>()[0],
+                    brickLength = internal::brick_size<Layout, widthAtCompileTime, lengthAtCompileTime>()[1];
+                constexpr int brickGrain = std::max(1, internal::kPARALLEL_GRAIN_SIZE / (brickWidth * brickLength));
+                internal::parallel_for_dispatch(0, bricksPerLayer * heightAtCompileTime, brickGrain, [this, &other](int begin, int end) {
+                    for (int brick = begin; brick < end; ++brick) {
+                        const int z = brick / bricksPerLayer;
+                        const auto origin = Layout::template brickOrigin<widthAtCompileTime, lengthAtCompileTime>(brick % bricksPerLayer);
+                        const int maxX = std::min(widthAtCompileTime, origin[0] + brickWidth),
+                            maxY = std::min(lengthAtCompileTime, origin[1] + brickLength);
+                        if constexpr (inStorageOrder) {
+                            if (maxX - origin[0] == brickWidth and maxY - origin[1] == brickLength) {
+                                const IndexType first = Layout::template index<widthAtCompileTime, lengthAtCompileTime,
+                                    heightAtCompileTime>(origin[0], origin[1], z);
+                                #pragma omp simd
+                                for (IndexType i = first; i < first + brickWidth * brickLength; ++i) {
+                                    (*this)(i) = other(i);
+                                }
+                                continue;
+                            }
+                        }
+                        for (int y = origin[1]; y < maxY; ++y) {
+                            #pragma omp simd
+                            for (int x = origin[0]; x < maxX; ++x) {
+                                (*this)(x, y, z) = other(x, y, z);
+                            }
+                        }
                     }
-                }
+                });
             }
 
             template <typename OtherTensor3>
-            constexpr STEALTH_ALWAYS_INLINE void copy_impl_3D(OtherTensor3&& other) {
-                #pragma omp parallel for simd
-                for (int z = 0; z < other.height(); ++z) {
-                    for (int j = 0; j < other.length(); ++j) {
-                        for (int i = 0; i < other.width(); ++i) {
-                            (*this)(i + j * other.width() + z * other.area()) = other(i, j, z);
+            constexpr STEALTH_ALWAYS_INLINE void copy_impl_select(const OtherTensor3& other) {
+                // Work on blocks so that when the mask is uniform, only one operand has to be evaluated. Only used
+                // with flat indexing, so the size fits in an int.
+                constexpr int size = static_cast<int>(Tensor3::size());
+                constexpr int numBlocks = (size + internal::kSELECT_BLOCK_SIZE - 1) / internal::kSELECT_BLOCK_SIZE;
+                constexpr int blockGrain = internal::kPARALLEL_GRAIN_SIZE / internal::kSELECT_BLOCK_SIZE;
+                internal::parallel_for_dispatch(0, numBlocks, blockGrain, [this, &other](int firstBlock, int lastBlock) {
+                    for (int block = firstBlock; block < lastBlock; ++block) {
+                        const int begin = block * internal::kSELECT_BLOCK_SIZE;
+                        const int end = std::min(begin + internal::kSELECT_BLOCK_SIZE, int{size});
+                        int numTrue = 0;
+                        #pragma omp simd reduction(+:numTrue)
+                        for (int i = begin; i < end; ++i) {
+                            numTrue += other.condition(i);
+                        }
+                        if (numTrue == end - begin) {
+                            #pragma omp simd
+                            for (int i = begin; i < end; ++i) {
+                                (*this)(i) = other.whenTrue(i);
+                            }
+                        } else if (numTrue == 0) {
+                            #pragma omp simd
+                            for (int i = begin; i < end; ++i) {
+                                (*this)(i) = other.whenFalse(i);
+                            }
+                        } else {
+                            #pragma omp simd
+                            for (int i = begin; i < end; ++i) {
+                                (*this)(i) = other(i);
+                            }
                         }
                     }
-                }
+                });
             }
 
-            template <typename OtherTensor3>
+            template <StorePolicy policy, typename OtherTensor3>
             constexpr STEALTH_ALWAYS_INLINE void copy_impl(OtherTensor3&& other) {
                 static_assert(other.size() == Tensor3::size(), "Cannot copy incompatible Tensor3s.");
+                // Evaluate x directly for x * 1, x + 0 and the like.
+                if constexpr (internal::identity_constant_side<OtherTensor3>() != 0) {
+                    if (internal::is_identity(other)) return copy_impl<policy>(internal::identity_operand(other));
+                }
                 constexpr int indexingModeToUse = std::max(internal::traits<Tensor3>::indexingMode,
                     internal::traits<OtherTensor3>::indexingMode);
 
@@ -230,31 +424,54 @@ namespace Stealth::Tensor {
                     std::cout << "\t\t!!!!Doing copy using indexing mode: " << indexingModeToUse << '\n';
                 #endif
 
+                // Ring buffers unwrap themselves a contiguous run at a time, and compressed tensors decode a row at a time.
+                if constexpr (internal::traits<OtherTensor3>::exprType == internal::ExpressionType::RingTensor3
+                    or internal::traits<OtherTensor3>::exprType == internal::ExpressionType::CompressedTensor3) {
+                    return other.copyTo(*this);
+                }
+                // Operands laid out the same way as a tiled destination can still be read in storage order, all at once
+                // if there is no padding to skip.
+                else if constexpr (not internal::is_row_major<Layout>) {
+                    constexpr bool sharesLayout = internal::shares_layout<Layout, widthAtCompileTime, lengthAtCompileTime,
+                        heightAtCompileTime, OtherTensor3>();
+                    if constexpr (sharesLayout and kSTORAGE_SIZE == Tensor3::size()) {
+                        return copy_impl_1D<policy>(std::forward<OtherTensor3&&>(other));
+                    } else {
+                        return copy_impl_bricks<sharesLayout>(std::forward<OtherTensor3&&>(other));
+                    }
+                }
+                // Selects that can be treated as a 1D array get to skip uniform blocks. They always use cached stores.
+                else if constexpr (indexingModeToUse == 1
+                    and internal::traits<OtherTensor3>::exprType == internal::ExpressionType::SelectExpr) {
+                    return copy_impl_select(std::forward<OtherTensor3&&>(other));
+                }
                 // Treat it as a 1D array
-                if constexpr (indexingModeToUse == 1) return copy_impl_1D(std::forward<OtherTensor3&&>(other));
+                else if constexpr (indexingModeToUse == 1) return copy_impl_1D<policy>(std::forward<OtherTensor3&&>(other));
                 // Treat it as a long 2D array.
-                else if constexpr (indexingModeToUse == 2) return copy_impl_2D(std::forward<OtherTensor3&&>(other));
+                else if constexpr (indexingModeToUse == 2) return copy_impl_2D<policy>(std::forward<OtherTensor3&&>(other));
                 // Copy as 3D array.
-                else return copy_impl_3D(std::forward<OtherTensor3&&>(other));
+                else return copy_impl_3D<policy>(std::forward<OtherTensor3&&>(other));
             }
 
-            template <typename OtherTensor3>
+            template <StorePolicy policy = StorePolicy::Auto, typename OtherTensor3>
             constexpr STEALTH_ALWAYS_INLINE void copy(OtherTensor3&& other) {
                 // If the other thing is a scalar, use the copy scalar function.
-                if constexpr (std::is_scalar<raw_type<OtherTensor3>>::value) return assign_scalar_impl(other);
-                else return copy_impl(std::forward<OtherTensor3&&>(other));
+                if constexpr (std::is_scalar<raw_type<OtherTensor3>>::value) return assign_scalar_impl<policy>(other);
+                else return copy_impl<policy>(std::forward<OtherTensor3&&>(other));
             }
 
             template <typename OtherTensor3>
             constexpr STEALTH_ALWAYS_INLINE void move_impl(OtherTensor3&& other) {
                 static_assert(other.size() == Tensor3::size(), "Cannot move incompatible Tensor3s");
+                static_assert(internal::is_row_major<Layout> or (other.width() == Tensor3::width()
+                    and other.length() == Tensor3::length()), "Cannot reshape a Tensor3 that is not row-major");
                 mData = Stealth::move(other.elements());
             }
 
             template <typename OtherTensor3>
             constexpr STEALTH_ALWAYS_INLINE void move(OtherTensor3&& other) {
                 // If the other thing is a scalar, use the copy scalar function.
-                if constexpr (std::is_scalar<raw_type<OtherTensor3>>::value) return assign_scalar_impl(other);
+                if constexpr (std::is_scalar<raw_type<OtherTensor3>>::value) return assign_scalar_impl<StorePolicy::Auto>(other);
                 else return move_impl(std::forward<OtherTensor3&&>(other));
             }
 
@@ -0,0 +1,101 @@
+#pragma once
+#include "ForwardDeclarations.hpp"
+#include "Tensor3.hpp"
+#include "StringPool.hpp"
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace Stealth::Tensor {
+    // Base for field tags whose tiles hold strings. They are stored as handles into the map's StringPool.
+    struct StringField {
+        using ScalarType = StringHandle;
+    };
+
+    namespace internal {
+        template <typename Field, typename... Fields>
+        struct field_index;
+
+        template <typename Field, typename... Rest>
+        struct field_index<Field, Field, Rest...> : std::integral_constant<int, 0> { };
+
+        template <typename Field, typename First, typename... Rest>
+        struct field_index<Field, First, Rest...> : std::integral_constant<int, 1 + field_index<Field, Rest...>::value> { };
+    } /* internal */
+
+    // Struct-of-arrays tile map. Each field is named by a tag type with a ScalarType member, and lives in
+    // its own dense Tensor3 plane, so passes over one field only bring that field through the cache.
+    // Fields are ordinary Tensor3s and can be used in any expression:
+    //
+    //     struct Elevation { using ScalarType = float; };
+    //     struct Biome : StringField { };
+    //     TileMap<64, 64, 1, Elevation, Biome> map;
+    //     map.field<Elevation>() = map.field<Elevation>() * 2.0f;
+    //     auto isWater = map.field<Biome>() == map.strings().find("water");
+    template <int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime, typename... Fields>
+    class TileMap {
+        public:
+            template <typename Field>
+            using FieldType = Tensor3<typename Field::ScalarType, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>;
+
+            constexpr STEALTH_ALWAYS_INLINE TileMap() noexcept { }
+
+            static constexpr STEALTH_ALWAYS_INLINE auto width() noexcept {
+                return widthAtCompileTime;
+            }
+
+            static constexpr STEALTH_ALWAYS_INLINE auto length() noexcept {
+                return lengthAtCompileTime;
+            }
+
+            static constexpr STEALTH_ALWAYS_INLINE auto height() noexcept {
+                return heightAtCompileTime;
+            }
+
+            static constexpr STEALTH_ALWAYS_INLINE auto numFields() noexcept {
+                return static_cast<int>(sizeof...(Fields));
+            }
+
+            template <typename Field>
+            constexpr STEALTH_ALWAYS_INLINE FieldType<Field>& field() noexcept {
+                return std::get<internal::field_index<Field, Fields...>::value>(mFields);
+            }
+
+            template <typename Field>
+            constexpr STEALTH_ALWAYS_INLINE const FieldType<Field>& field() const noexcept {
+                return std::get<internal::field_index<Field, Fields...>::value>(mFields);
+            }
+
+            // All fields of one tile, as a tuple of references in declaration order.
+            constexpr STEALTH_ALWAYS_INLINE auto tile(int x, int y = 0, int z = 0) noexcept {
+                return std::tie(field<Fields>()(x, y, z)...);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto tile(int x, int y = 0, int z = 0) const noexcept {
+                return std::tie(field<Fields>()(x, y, z)...);
+            }
+
+            template <typename Field>
+            const std::string& string(int x, int y = 0, int z = 0) const noexcept {
+                static_assert(std::is_base_of<StringField, Field>::value, "Field does not hold strings");
+                return mStrings[field<Field>()(x, y, z)];
+            }
+
+            template <typename Field>
+            void setString(std::string_view str, int x, int y = 0, int z = 0) {
+                static_assert(std::is_base_of<StringField, Field>::value, "Field does not hold strings");
+                field<Field>()(x, y, z) = mStrings.intern(str);
+            }
+
+            StringPool& strings() noexcept {
+                return mStrings;
+            }
+
+            const StringPool& strings() const noexcept {
+                return mStrings;
+            }
+        private:
+            std::tuple<FieldType<Fields>...> mFields;
+            StringPool mStrings;
+    };
+} /* Stealth::Tensor */
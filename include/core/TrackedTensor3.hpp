@@ -0,0 +1,163 @@
+#pragma once
+#include "ForwardDeclarations.hpp"
+#include "Tensor3.hpp"
+#include <algorithm>
+
+namespace Stealth::Tensor {
+    namespace internal {
+        // Writes are tracked at the granularity of chunks of this size within each layer.
+        constexpr int kDIRTY_CHUNK_WIDTH = 16;
+        constexpr int kDIRTY_CHUNK_LENGTH = 16;
+
+        template <typename type, int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime>
+        struct traits<TrackedTensor3<type, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>>
+            : traits<Tensor3<type, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>> {
+            static constexpr ExpressionType exprType = ExpressionType::TrackedTensor3;
+        };
+    } /* internal */
+
+    // Every non-const access marks the containing chunk as dirty. Reads through
+    // expressions always use the const accessors and are never recorded.
+    template <typename ScalarType, int widthAtCompileTime, int lengthAtCompileTime, int heightAtCompileTime>
+    class TrackedTensor3 : public Tensor3Base<TrackedTensor3<ScalarType, widthAtCompileTime, lengthAtCompileTime,
+        heightAtCompileTime>> {
+        static constexpr int kCHUNKS_X = (widthAtCompileTime + internal::kDIRTY_CHUNK_WIDTH - 1)
+            / internal::kDIRTY_CHUNK_WIDTH;
+        static constexpr int kCHUNKS_Y = (lengthAtCompileTime + internal::kDIRTY_CHUNK_LENGTH - 1)
+            / internal::kDIRTY_CHUNK_LENGTH;
+
+        public:
+            using TensorType = Tensor3<ScalarType, widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime>;
+
+            constexpr STEALTH_ALWAYS_INLINE TrackedTensor3() noexcept {
+                clearDirty();
+            }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE TrackedTensor3(OtherTensor3&& other) : mTensor3(std::forward<OtherTensor3&&>(other)) {
+                markAllDirty();
+            }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE TrackedTensor3& operator=(OtherTensor3&& other) {
+                mTensor3 = std::forward<OtherTensor3&&>(other);
+                markAllDirty();
+                return *this;
+            }
+
+            // Accessors
+            constexpr STEALTH_ALWAYS_INLINE auto& operator()(int x, int y, int z) {
+                markDirty(x, y, z);
+                return mTensor3(x, y, z);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& operator()(int x, int y, int z) const {
+                return mTensor3(x, y, z);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto& operator()(int x, int y) {
+                markDirty(x, y % lengthAtCompileTime, y / lengthAtCompileTime);
+                return mTensor3(x, y);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& operator()(int x, int y) const {
+                return mTensor3(x, y);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE auto& operator()(int x) {
+                markDirty(x % widthAtCompileTime, (x / widthAtCompileTime) % lengthAtCompileTime,
+                    x / (widthAtCompileTime * lengthAtCompileTime));
+                return mTensor3(x);
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const auto& operator()(int x) const {
+                return mTensor3(x);
+            }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void operator+=(OtherTensor3&& other) {
+                mTensor3 += std::forward<OtherTensor3&&>(other);
+                markAllDirty();
+            }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void operator-=(OtherTensor3&& other) {
+                mTensor3 -= std::forward<OtherTensor3&&>(other);
+                markAllDirty();
+            }
+
+            template <typename OtherTensor3>
+            constexpr STEALTH_ALWAYS_INLINE void operator/=(OtherTensor3&& other) {
+                mTensor3 /= std::forward<OtherTensor3&&>(other);
+                markAllDirty();
+            }
+
+            // Dirty tracking
+            constexpr STEALTH_ALWAYS_INLINE void markDirty(int x, int y, int z) noexcept {
+                mDirtyChunks(x / internal::kDIRTY_CHUNK_WIDTH, y / internal::kDIRTY_CHUNK_LENGTH, z) = 1;
+            }
+
+            constexpr void markDirty(const Region& region) noexcept {
+                if (region.empty()) return;
+                const int maxChunkX = (region.maxX - 1) / internal::kDIRTY_CHUNK_WIDTH,
+                    maxChunkY = (region.maxY - 1) / internal::kDIRTY_CHUNK_LENGTH;
+                for (int z = region.minZ; z < region.maxZ; ++z) {
+                    for (int y = region.minY / internal::kDIRTY_CHUNK_LENGTH; y <= maxChunkY; ++y) {
+                        for (int x = region.minX / internal::kDIRTY_CHUNK_WIDTH; x <= maxChunkX; ++x) {
+                            mDirtyChunks(x, y, z) = 1;
+                        }
+                    }
+                }
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE void markAllDirty() noexcept {
+                for (int i = 0; i < mDirtyChunks.size(); ++i) {
+                    mDirtyChunks(i) = 1;
+                }
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE void clearDirty() noexcept {
+                for (int i = 0; i < mDirtyChunks.size(); ++i) {
+                    mDirtyChunks(i) = 0;
+                }
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE bool isDirty(int x, int y, int z) const noexcept {
+                return mDirtyChunks(x / internal::kDIRTY_CHUNK_WIDTH, y / internal::kDIRTY_CHUNK_LENGTH, z);
+            }
+
+            // Bounding box of all dirty chunks, clamped to the tensor. Empty if nothing was written.
+            constexpr Region dirtyRegion() const noexcept {
+                Region region{widthAtCompileTime, lengthAtCompileTime, heightAtCompileTime, 0, 0, 0};
+                for (int z = 0; z < heightAtCompileTime; ++z) {
+                    for (int y = 0; y < kCHUNKS_Y; ++y) {
+                        for (int x = 0; x < kCHUNKS_X; ++x) {
+                            if (!mDirtyChunks(x, y, z)) continue;
+                            region.minX = std::min(region.minX, x * internal::kDIRTY_CHUNK_WIDTH);
+                            region.minY = std::min(region.minY, y * internal::kDIRTY_CHUNK_LENGTH);
+                            region.minZ = std::min(region.minZ, z);
+                            region.maxX = std::max(region.maxX, std::min(widthAtCompileTime,
+                                (x + 1) * internal::kDIRTY_CHUNK_WIDTH));
+                            region.maxY = std::max(region.maxY, std::min(lengthAtCompileTime,
+                                (y + 1) * internal::kDIRTY_CHUNK_LENGTH));
+                            region.maxZ = std::max(region.maxZ, z + 1);
+                        }
+                    }
+                }
+                return region;
+            }
+
+            // Access without recording writes, for callers that mark regions themselves.
+            constexpr STEALTH_ALWAYS_INLINE TensorType& untracked() noexcept {
+                return mTensor3;
+            }
+
+            constexpr STEALTH_ALWAYS_INLINE const TensorType& tensor3() const noexcept {
+                return mTensor3;
+            }
+
+        private:
+            TensorType mTensor3;
+            Tensor3<unsigned char, kCHUNKS_X, kCHUNKS_Y, heightAtCompileTime> mDirtyChunks;
+    };
+} /* Stealth::Tensor */
@@ -1,5 +1,6 @@
 #pragma once
 #include <type_traits>
+#include <utility>
 #include <Stealth/util>
 
 namespace Stealth::Tensor {
@@ -3,6 +3,18 @@
 #include <Stealth/util>
 #include <iostream>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 constexpr int kTEST_WIDTH = 30;
 constexpr int kTEST_LENGTH = 30;
@@ -21,6 +33,18 @@ constexpr auto SequentialTensor3F(int startValue = 0) noexcept {
     return out;
 }
 
+// Reproducible pseudo-random values in [0, modulus), from a linear congruential generator.
+template <int width = 1, int length = 1, int height = 1>
+auto RandomTensor3I(unsigned seed, int modulus) {
+    Stealth::Tensor::Tensor3I<width, length, height> out;
+    unsigned state = seed;
+    for (int i = 0; i < out.size(); ++i) {
+        state = state * 1103515245u + 12345u;
+        out(i) = static_cast<int>((state >> 16) % static_cast<unsigned>(modulus));
+    }
+    return out;
+}
+
 struct TestResult {
     TestResult(bool passed = true, std::string errorMessage = {}, std::string testName = __builtin_FUNCTION())
         : passed{passed}, testName{testName}, errorMessage{errorMessage} { }
@@ -156,6 +180,117 @@ bool testBlockOps() {
     return allTestsPassed;
 }
 
+namespace View {
+    TestResult testStep() {
+        auto viewTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        // Downsample by 2 along x and y.
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH / 2, kTEST_LENGTH / 2, kTEST_HEIGHT> result
+            = Stealth::Tensor::step<2, 2>(viewTest0);
+        int numIncorrect = 0;
+        for (int k = 0; k < result.height(); ++k) {
+            for (int j = 0; j < result.length(); ++j) {
+                for (int i = 0; i < result.width(); ++i) {
+                    numIncorrect += result(i, j, k) != viewTest0(i * 2, j * 2, k);
+                }
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testReverse() {
+        auto viewTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH>();
+        Stealth::Tensor::MatrixF<kTEST_WIDTH, kTEST_LENGTH> result = Stealth::Tensor::reverse<true, true>(viewTest0);
+        int numIncorrect = 0;
+        for (int j = 0; j < result.length(); ++j) {
+            for (int i = 0; i < result.width(); ++i) {
+                numIncorrect += result(i, j) != viewTest0(kTEST_WIDTH - 1 - i, kTEST_LENGTH - 1 - j);
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testTranspose() {
+        auto viewTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH / 2, kTEST_HEIGHT>();
+        Stealth::Tensor::Tensor3F<kTEST_LENGTH / 2, kTEST_WIDTH, kTEST_HEIGHT> result
+            = Stealth::Tensor::transpose(viewTest0);
+        int numIncorrect = 0;
+        for (int k = 0; k < result.height(); ++k) {
+            for (int j = 0; j < result.length(); ++j) {
+                for (int i = 0; i < result.width(); ++i) {
+                    numIncorrect += result(i, j, k) != viewTest0(j, i, k);
+                }
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testMaxPool() {
+        auto viewTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH / 3, kTEST_LENGTH / 3, kTEST_HEIGHT> result
+            = Stealth::Tensor::maxPool<3, 3>(viewTest0);
+        int numIncorrect = 0;
+        for (int k = 0; k < result.height(); ++k) {
+            for (int j = 0; j < result.length(); ++j) {
+                for (int i = 0; i < result.width(); ++i) {
+                    // In a sequential Tensor3, the maximum is always the last element of the window.
+                    numIncorrect += result(i, j, k) != viewTest0(i * 3 + 2, j * 3 + 2, k);
+                }
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testPyramid() {
+        auto viewTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        Stealth::Tensor::Pyramid<float, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT, 3> pyramid{viewTest0};
+        // Each level should match pooling the one below it.
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH / 2, kTEST_LENGTH / 2, kTEST_HEIGHT> level1
+            = Stealth::Tensor::avgPool(viewTest0);
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH / 4, kTEST_LENGTH / 4, kTEST_HEIGHT> level2
+            = Stealth::Tensor::avgPool(level1);
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH / 8, kTEST_LENGTH / 8, kTEST_HEIGHT> level3
+            = Stealth::Tensor::avgPool(level2);
+        int numIncorrect = 0;
+        for (int i = 0; i < level1.size(); ++i) {
+            numIncorrect += pyramid.level<1>()(i) != level1(i);
+        }
+        for (int i = 0; i < level2.size(); ++i) {
+            numIncorrect += pyramid.level<2>()(i) != level2(i);
+        }
+        for (int i = 0; i < level3.size(); ++i) {
+            numIncorrect += pyramid.level<3>()(i) != level3(i);
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testSmallIntegerPooling() {
+        // Sums of a window of 200s overflow unsigned char, but the averages must not.
+        Stealth::Tensor::Tensor3<unsigned char, 8, 8, 2> bytes;
+        bytes = static_cast<unsigned char>(200);
+        const Stealth::Tensor::Tensor3<unsigned char, 4, 4, 2> pooled = Stealth::Tensor::avgPool(bytes);
+        Stealth::Tensor::Pyramid<unsigned char, 8, 8, 2, 2> pyramid{bytes};
+        int numIncorrect = 0;
+        for (int i = 0; i < pooled.size(); ++i) {
+            numIncorrect += pooled(i) != 200 or pyramid.level<1>()(i) != 200;
+        }
+        for (int i = 0; i < pyramid.level<2>().size(); ++i) {
+            numIncorrect += pyramid.level<2>()(i) != 200;
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* View */
+
+bool testViewOps() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(View::testStep);
+    allTestsPassed &= runTest(View::testReverse);
+    allTestsPassed &= runTest(View::testTranspose);
+    allTestsPassed &= runTest(View::testMaxPool);
+    allTestsPassed &= runTest(View::testPyramid);
+    allTestsPassed &= runTest(View::testSmallIntegerPooling);
+    return allTestsPassed;
+}
+
 namespace Perf {
     TestResult testCopy() {
         auto perfTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
@@ -210,6 +345,64 @@ namespace Perf {
         return TestResult{};
     }
 
+    // Reports copy bandwidth for increasing thread counts. Run with pinned threads
+    // (OMP_PROC_BIND=spread OMP_PLACES=cores) to see scaling across sockets.
+    TestResult testBandwidthScaling() {
+        constexpr int kBANDWIDTH_ITERS = 20;
+        using LargeTensor3F = Stealth::Tensor::Tensor3F<1024, 1024, 4>;
+        Stealth::Tensor::PartitionedExecutor firstTouch;
+        Stealth::Tensor::ExecutorScope allocationScope{firstTouch};
+        // Pages are placed on their first write, so filling under the partitioned executor spreads
+        // them across the threads' nodes.
+        auto source0 = std::make_unique<LargeTensor3F>();
+        auto source1 = std::make_unique<LargeTensor3F>();
+        auto result = std::make_unique<LargeTensor3F>();
+        *source0 = 1.0f;
+        *source1 = 2.0f;
+        *result = 0.0f;
+        const int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+        int numIncorrect = 0;
+        for (int numThreads = 1; numThreads <= maxThreads; numThreads *= 2) {
+            Stealth::Tensor::PartitionedExecutor partitioned{numThreads};
+            Stealth::Tensor::ExecutorScope scope{partitioned};
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < kBANDWIDTH_ITERS; ++i) {
+                *result = *source0 + *source1;
+            }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            const double bytes = 3.0 * sizeof(float) * LargeTensor3F::size() * kBANDWIDTH_ITERS;
+            std::cout << "Bandwidth with " << numThreads << " thread(s): " << bytes / elapsed.count() / 1e9 << " GB/s\n";
+            numIncorrect += (*result)(LargeTensor3F::size() - 1) != 3.0f;
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+    // Compares cached and streaming stores on a sum whose destination is far larger than the cache.
+    TestResult testStreamingSum() {
+        constexpr int kSTREAMING_ITERS = 5;
+        using LargeTensor3F = Stealth::Tensor::Tensor3F<1024, 1024, 8>;
+        auto source0 = std::make_unique<LargeTensor3F>();
+        auto source1 = std::make_unique<LargeTensor3F>();
+        auto source2 = std::make_unique<LargeTensor3F>();
+        auto result = std::make_unique<LargeTensor3F>(Stealth::Tensor::kUNINITIALIZED);
+        *source0 = 1.0f;
+        *source1 = 2.0f;
+        *source2 = 3.0f;
+        int numIncorrect = 0;
+        const auto measure = [&](auto policy, const char* name) {
+            constexpr Stealth::Tensor::StorePolicy kPOLICY = decltype(policy)::value;
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < kSTREAMING_ITERS; ++i) {
+                result -> assign<kPOLICY>(*source0 + *source1 + *source2);
+            }
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            const double bytes = 4.0 * sizeof(float) * LargeTensor3F::size() * kSTREAMING_ITERS;
+            std::cout << "Bandwidth with " << name << " stores: " << bytes / elapsed.count() / 1e9 << " GB/s\n";
+            numIncorrect += (*result)(0) != 6.0f or (*result)(LargeTensor3F::size() - 1) != 6.0f;
+        };
+        measure(std::integral_constant<Stealth::Tensor::StorePolicy, Stealth::Tensor::StorePolicy::Cached>{}, "cached");
+        measure(std::integral_constant<Stealth::Tensor::StorePolicy, Stealth::Tensor::StorePolicy::Streaming>{}, "streaming");
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
 } /* Perf */
 
 bool testPerf() {
@@ -217,6 +410,8 @@ bool testPerf() {
     allTestsPassed &= runTest(Perf::testCopy);
     allTestsPassed &= runTest(Perf::testLargeSum);
     allTestsPassed &= runTest(Perf::testBlockSum);
+    allTestsPassed &= runTest(Perf::testBandwidthScaling);
+    allTestsPassed &= runTest(Perf::testStreamingSum);
     return allTestsPassed;
 }
 
@@ -261,6 +456,45 @@ namespace Binary {
         }
         return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
     }
+
+    TestResult testPrefetchedSums() {
+        auto binaryTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        auto binaryTest1 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>(1);
+        // Five streams are enough to prefetch a contiguous sum, and blocks are prefetched row by row.
+        auto longSum = binaryTest0 + binaryTest1 + binaryTest0 + binaryTest1 + binaryTest0;
+        static_assert(Stealth::Tensor::internal::prefetch_stream_count<decltype(longSum)>() == 5);
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> sum = longSum;
+        auto blockSum = Stealth::Tensor::block<kTEST_WIDTH / 2, kTEST_LENGTH / 2, kTEST_HEIGHT / 2>(binaryTest0, 2, 3, 4)
+            + Stealth::Tensor::block<kTEST_WIDTH / 2, kTEST_LENGTH / 2, kTEST_HEIGHT / 2>(binaryTest1, 5, 6, 7);
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH / 2, kTEST_LENGTH / 2, kTEST_HEIGHT / 2> blocks = blockSum;
+        int numIncorrect = 0;
+        for (int i = 0; i < sum.size(); ++i) {
+            numIncorrect += sum(i) != 3 * binaryTest0(i) + 2 * binaryTest1(i);
+        }
+        for (int k = 0; k < blocks.height(); ++k) {
+            for (int j = 0; j < blocks.length(); ++j) {
+                for (int i = 0; i < blocks.width(); ++i) {
+                    numIncorrect += blocks(i, j, k) != binaryTest0(i + 2, j + 3, k + 4) + binaryTest1(i + 5, j + 6, k + 7);
+                }
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    // Iterators and smart pointers over Tensor3s are not expressions, and keep their usual operators.
+    TestResult testNonExpressionOperands() {
+        std::vector<Stealth::Tensor::Tensor3F<2, 2, 2>> tensors(3);
+        const auto pointer = std::make_unique<Stealth::Tensor::Tensor3F<2, 2, 2>>();
+        static_assert(std::is_same<decltype(tensors.begin() != tensors.end()), bool>::value);
+        static_assert(std::is_same<decltype(tensors.end() - tensors.begin()), std::ptrdiff_t>::value);
+        static_assert(std::is_same<decltype(pointer == nullptr), bool>::value);
+        static_assert(std::is_same<decltype(!pointer), bool>::value);
+        int numIncorrect = tensors.end() - tensors.begin() != 3;
+        numIncorrect += tensors.begin() == tensors.end();
+        numIncorrect += pointer == nullptr;
+        numIncorrect += !pointer;
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
 } /* Binary */
 
 bool testBinary() {
@@ -268,6 +502,1309 @@ bool testBinary() {
     allTestsPassed &= runTest(Binary::testSum);
     allTestsPassed &= runTest(Binary::test1DBroadcastOver2DSum);
     allTestsPassed &= runTest(Binary::testScalarMultiply);
+    allTestsPassed &= runTest(Binary::testPrefetchedSums);
+    allTestsPassed &= runTest(Binary::testNonExpressionOperands);
+    return allTestsPassed;
+}
+
+namespace Select {
+    TestResult testSelect() {
+        auto selectTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        constexpr float kTHRESHOLD = kTEST_SIZE / 3;
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> result
+            = Stealth::Tensor::select(selectTest0 < kTHRESHOLD, selectTest0, -1.0f);
+        int numIncorrect = 0;
+        for (int i = 0; i < result.size(); ++i) {
+            numIncorrect += result(i) != (i < kTHRESHOLD ? i : -1.0f);
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testSelectBroadcast() {
+        auto selectTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH>();
+        auto selectTest1 = SequentialTensor3F<kTEST_WIDTH, 1>();
+        // Select using a row-vector mask, which cannot be evaluated in 1D.
+        Stealth::Tensor::MatrixF<kTEST_WIDTH, kTEST_LENGTH> result
+            = Stealth::Tensor::select(selectTest1 < kTEST_WIDTH / 2, selectTest0, selectTest1);
+        int numIncorrect = 0;
+        for (int j = 0; j < result.length(); ++j) {
+            for (int i = 0; i < result.width(); ++i) {
+                numIncorrect += result(i, j) != (i < kTEST_WIDTH / 2 ? selectTest0(i, j) : i);
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Select */
+
+bool testSelect() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Select::testSelect);
+    allTestsPassed &= runTest(Select::testSelectBroadcast);
+    return allTestsPassed;
+}
+
+namespace Scan {
+    TestResult testLongCumsum() {
+        // Long enough to use the chunked parallel scan.
+        Stealth::Tensor::VectorD<kTEST_SIZE> scanTest0;
+        for (int i = 0; i < scanTest0.size(); ++i) {
+            scanTest0(i) = i;
+        }
+        Stealth::Tensor::VectorD<kTEST_SIZE> result;
+        Stealth::Tensor::cumsum<0>(result, scanTest0);
+        int numIncorrect = 0;
+        for (int i = 0; i < result.size(); ++i) {
+            numIncorrect += result(i) != (static_cast<double>(i) * (i + 1)) / 2;
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testExclusiveCumsumZ() {
+        auto scanTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> result;
+        Stealth::Tensor::cumsum<2, false>(result, scanTest0);
+        int numIncorrect = 0;
+        for (int j = 0; j < result.length(); ++j) {
+            for (int i = 0; i < result.width(); ++i) {
+                float expected = 0.0f;
+                for (int k = 0; k < result.height(); ++k) {
+                    numIncorrect += result(i, j, k) != expected;
+                    expected += scanTest0(i, j, k);
+                }
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testCummaxIntoBlock() {
+        auto scanTest0 = Stealth::Tensor::reverse<false, true>(SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH>()).eval();
+        Stealth::Tensor::MatrixF<kTEST_WIDTH, kTEST_LENGTH> result{};
+        // Scan the bottom half of the rows into the top half of the result.
+        Stealth::Tensor::cummax<1>(Stealth::Tensor::block<kTEST_WIDTH, kTEST_LENGTH / 2>(result),
+            Stealth::Tensor::block<kTEST_WIDTH, kTEST_LENGTH / 2>(scanTest0, 0, kTEST_LENGTH / 2));
+        int numIncorrect = 0;
+        for (int j = 0; j < kTEST_LENGTH / 2; ++j) {
+            for (int i = 0; i < kTEST_WIDTH; ++i) {
+                // Rows are decreasing, so the maximum is always the first row scanned.
+                numIncorrect += result(i, j) != scanTest0(i, kTEST_LENGTH / 2);
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testRowScans() {
+        // Rows shorter than a block, and a long row that is scanned in blocks and chunks.
+        Stealth::Tensor::Tensor3I<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> scanTest0, exclusive;
+        Stealth::Tensor::VectorI<kTEST_SIZE> longTest0, longExclusive, lastNonzero;
+        for (int i = 0; i < scanTest0.size(); ++i) {
+            scanTest0(i) = (i * 7) % 11 - 3;
+            longTest0(i) = scanTest0(i);
+        }
+        Stealth::Tensor::cumsum<0, false>(exclusive, scanTest0);
+        Stealth::Tensor::cumsum<0, false>(longExclusive, longTest0);
+        // Associative but not commutative, so the order of operands must be kept.
+        Stealth::Tensor::scan<0>(lastNonzero, longTest0, [](int lhs, int rhs) { return rhs == 0 ? lhs : rhs; }, 0);
+        int numIncorrect = 0;
+        int longExpected = 0, expectedNonzero = 0;
+        for (int row = 0; row < kTEST_LENGTH * kTEST_HEIGHT; ++row) {
+            int expected = 0;
+            for (int x = 0; x < kTEST_WIDTH; ++x) {
+                const int i = x + row * kTEST_WIDTH;
+                numIncorrect += exclusive(i) != expected or longExclusive(i) != longExpected;
+                expected += scanTest0(i);
+                longExpected += scanTest0(i);
+                if (scanTest0(i) != 0) expectedNonzero = scanTest0(i);
+                numIncorrect += lastNonzero(i) != expectedNonzero;
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Scan */
+
+bool testScan() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Scan::testLongCumsum);
+    allTestsPassed &= runTest(Scan::testExclusiveCumsumZ);
+    allTestsPassed &= runTest(Scan::testCummaxIntoBlock);
+    allTestsPassed &= runTest(Scan::testRowScans);
+    return allTestsPassed;
+}
+
+namespace SummedArea {
+    template <typename Tensor3Type>
+    double bruteForceSum(const Tensor3Type& tensor3, int x0, int y0, int z0, int x1, int y1, int z1) {
+        double sum = 0;
+        for (int k = z0; k < z1; ++k) {
+            for (int j = y0; j < y1; ++j) {
+                for (int i = x0; i < x1; ++i) {
+                    sum += tensor3(i, j, k);
+                }
+            }
+        }
+        return sum;
+    }
+
+    TestResult testRegionSum() {
+        auto satTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        Stealth::Tensor::SummedAreaTable<double, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> table{satTest0};
+        int numIncorrect = 0;
+        numIncorrect += table.regionSum(0, 0, 0, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT)
+            != bruteForceSum(satTest0, 0, 0, 0, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT);
+        numIncorrect += table.regionSum(3, 5, 7, 20, 11, 29) != bruteForceSum(satTest0, 3, 5, 7, 20, 11, 29);
+        numIncorrect += table.regionSum(4, 4, 6, 6) != bruteForceSum(satTest0, 4, 4, 0, 6, 6, kTEST_HEIGHT);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testIncrementalUpdate() {
+        auto satTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        Stealth::Tensor::SummedAreaTable<double, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> table{satTest0};
+        // Modify a few tiles and only rebuild from the first affected row and layer.
+        satTest0(4, 12, 9) = -100.0f;
+        satTest0(20, 25, 17) = 1000.0f;
+        table.update(satTest0, 12, 9);
+        int numIncorrect = 0;
+        numIncorrect += table.regionSum(0, 0, 0, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT)
+            != bruteForceSum(satTest0, 0, 0, 0, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT);
+        numIncorrect += table.regionSum(2, 10, 8, 21, 26, 18) != bruteForceSum(satTest0, 2, 10, 8, 21, 26, 18);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* SummedArea */
+
+bool testSummedArea() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(SummedArea::testRegionSum);
+    allTestsPassed &= runTest(SummedArea::testIncrementalUpdate);
+    return allTestsPassed;
+}
+
+namespace GatherScatter {
+    constexpr int kNUM_TILE_TYPES = 8;
+
+    TestResult testGather() {
+        Stealth::Tensor::Tensor3I<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> tileIDs;
+        for (int i = 0; i < tileIDs.size(); ++i) {
+            tileIDs(i) = i % kNUM_TILE_TYPES;
+        }
+        // Map each tile ID to a cost.
+        auto costs = SequentialTensor3F<kNUM_TILE_TYPES>();
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> result
+            = Stealth::Tensor::gather(costs, tileIDs) * 2.0f;
+        int numIncorrect = 0;
+        for (int i = 0; i < result.size(); ++i) {
+            numIncorrect += result(i) != (i % kNUM_TILE_TYPES) * 2.0f;
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testScatterAdd() {
+        Stealth::Tensor::Tensor3I<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> positions;
+        for (int i = 0; i < positions.size(); ++i) {
+            positions(i) = i % kNUM_TILE_TYPES;
+        }
+        // Count how many units land on each tile.
+        Stealth::Tensor::VectorI<kNUM_TILE_TYPES> density{};
+        Stealth::Tensor::scatter_add(density, positions, 1);
+        // Per-index values, and a single element broadcast to every index.
+        Stealth::Tensor::VectorI<kNUM_TILE_TYPES> weighted{}, broadcast{};
+        Stealth::Tensor::scatter_add(weighted, positions, positions);
+        Stealth::Tensor::scatter_add(broadcast, positions, Stealth::Tensor::Tensor3I<1, 1, 1>{3});
+        int numIncorrect = 0;
+        for (int i = 0; i < density.size(); ++i) {
+            numIncorrect += density(i) != kTEST_SIZE / kNUM_TILE_TYPES;
+            numIncorrect += weighted(i) != i * (kTEST_SIZE / kNUM_TILE_TYPES);
+            numIncorrect += broadcast(i) != 3 * (kTEST_SIZE / kNUM_TILE_TYPES);
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testLargeScatterAdd() {
+        // Each task's copy of a 16 MB destination must come from the heap rather than the stack.
+        constexpr int kDEST_SIZE = 1 << 22;
+        Stealth::Tensor::VectorI<kDEST_SIZE> density{};
+        Stealth::Tensor::VectorI<kDEST_SIZE * 2> positions;
+        for (int i = 0; i < positions.size(); ++i) {
+            positions(i) = (i * 7) % kDEST_SIZE;
+        }
+        Stealth::Tensor::scatter_add(density, positions, 1);
+        int numIncorrect = 0;
+        for (int i = 0; i < density.size(); ++i) {
+            numIncorrect += density(i) != 2;
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testNonzero() {
+        // Several chunks of rows, with matches spread across all of them.
+        Stealth::Tensor::Tensor3I<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> hp, owner, ids;
+        for (int i = 0; i < owner.size(); ++i) {
+            hp(i) = (i % 7 == 0) ? 5 : 50;
+            owner(i) = i % 3;
+            ids(i) = i;
+        }
+        const auto predicate = hp < 10 && owner == 1;
+        const std::vector<int> indices = Stealth::Tensor::nonzero(predicate);
+        const std::vector<std::array<int, 3>> coordinates = Stealth::Tensor::find(predicate);
+        const auto compacted = Stealth::Tensor::compact(predicate, ids * 2);
+        std::vector<int> expected;
+        for (int i = 0; i < hp.size(); ++i) {
+            if (i % 7 == 0 and i % 3 == 1) expected.push_back(i);
+        }
+        int numIncorrect = indices != expected;
+        numIncorrect += compacted.indices != expected;
+        numIncorrect += coordinates.size() != expected.size() or compacted.values.size() != expected.size();
+        for (int i = 0; i < static_cast<int>(std::min(expected.size(), coordinates.size())); ++i) {
+            const auto& coordinate = coordinates[i];
+            numIncorrect += coordinate[0] + kTEST_WIDTH * (coordinate[1] + kTEST_LENGTH * coordinate[2]) != expected[i];
+            numIncorrect += compacted.values[i] != expected[i] * 2;
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testHistogram() {
+        Stealth::Tensor::Tensor3I<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> tileIDs;
+        for (int i = 0; i < tileIDs.size(); ++i) {
+            tileIDs(i) = i % kNUM_TILE_TYPES;
+        }
+        const std::vector<int> counts = Stealth::Tensor::histogram(tileIDs, kNUM_TILE_TYPES);
+        // Only the first half of each row, with the upper half of the tile IDs masked out.
+        const auto region = Stealth::Tensor::block<kTEST_WIDTH / 2, kTEST_LENGTH, kTEST_HEIGHT>(tileIDs);
+        const std::vector<int> maskedCounts = Stealth::Tensor::histogram(
+            Stealth::Tensor::select(region < kNUM_TILE_TYPES / 2, region, -1), kNUM_TILE_TYPES);
+        std::vector<int> expectedMaskedCounts(kNUM_TILE_TYPES, 0);
+        for (int z = 0; z < kTEST_HEIGHT; ++z) {
+            for (int y = 0; y < kTEST_LENGTH; ++y) {
+                for (int x = 0; x < kTEST_WIDTH / 2; ++x) {
+                    const int id = tileIDs(x, y, z);
+                    expectedMaskedCounts[id] += id < kNUM_TILE_TYPES / 2;
+                }
+            }
+        }
+        int numIncorrect = counts != std::vector<int>(kNUM_TILE_TYPES, kTEST_SIZE / kNUM_TILE_TYPES);
+        numIncorrect += maskedCounts != expectedMaskedCounts;
+        numIncorrect += Stealth::Tensor::countUnique(Stealth::Tensor::select(region < kNUM_TILE_TYPES / 2, region, -1),
+            kNUM_TILE_TYPES) != kNUM_TILE_TYPES / 2;
+        // Unsigned IDs past the last bin are skipped the same way.
+        Stealth::Tensor::Tensor3<unsigned, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> unsignedIDs;
+        for (int i = 0; i < unsignedIDs.size(); ++i) {
+            unsignedIDs(i) = static_cast<unsigned>(i % (kNUM_TILE_TYPES + 2));
+        }
+        numIncorrect += Stealth::Tensor::histogram(unsignedIDs, kNUM_TILE_TYPES)
+            != std::vector<int>(kNUM_TILE_TYPES, kTEST_SIZE / (kNUM_TILE_TYPES + 2));
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* GatherScatter */
+
+bool testGatherScatter() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(GatherScatter::testGather);
+    allTestsPassed &= runTest(GatherScatter::testScatterAdd);
+    allTestsPassed &= runTest(GatherScatter::testLargeScatterAdd);
+    allTestsPassed &= runTest(GatherScatter::testNonzero);
+    allTestsPassed &= runTest(GatherScatter::testHistogram);
+    return allTestsPassed;
+}
+
+namespace Fused {
+    TestResult testFuse() {
+        // Destinations of the same size but different shapes cannot be fused, since every target is indexed
+        // with the first one's dimensions.
+        using Square = Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, 1>;
+        using Line = Stealth::Tensor::Tensor3F<kTEST_WIDTH * kTEST_LENGTH, 1, 1>;
+        static_assert(Stealth::Tensor::internal::fusable_shapes<Stealth::Tensor::Assignment<Square, Square&>,
+            Stealth::Tensor::Assignment<Square, const Square&>>);
+        static_assert(not Stealth::Tensor::internal::fusable_shapes<Stealth::Tensor::Assignment<Square, Square&>,
+            Stealth::Tensor::Assignment<Line, Line&>>);
+        static_assert(not Stealth::Tensor::internal::fusable_shapes<Stealth::Tensor::Assignment<Line, Square&>>);
+        auto fusedTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        auto fusedTest1 = Stealth::Tensor::reverse(fusedTest0).eval();
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> sum, difference, maximum;
+        Stealth::Tensor::fuse(
+            Stealth::Tensor::assign(sum, fusedTest0 + fusedTest1),
+            Stealth::Tensor::assign(difference, fusedTest0 - fusedTest1),
+            Stealth::Tensor::assign(maximum, Stealth::Tensor::max(fusedTest0, fusedTest1))
+        );
+        int numIncorrect = 0;
+        for (int i = 0; i < sum.size(); ++i) {
+            numIncorrect += sum(i) != fusedTest0(i) + fusedTest1(i);
+            numIncorrect += difference(i) != fusedTest0(i) - fusedTest1(i);
+            numIncorrect += maximum(i) != std::max(fusedTest0(i), fusedTest1(i));
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testFuseBlocks() {
+        auto fusedTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH / 2, kTEST_LENGTH / 2, kTEST_HEIGHT / 2> doubled, squared;
+        auto region = Stealth::Tensor::block<kTEST_WIDTH / 2, kTEST_LENGTH / 2, kTEST_HEIGHT / 2>(fusedTest0, 3, 4, 5);
+        // The block forces 3D indexing for the whole group.
+        Stealth::Tensor::fuse(
+            Stealth::Tensor::assign(doubled, region * 2.0f),
+            Stealth::Tensor::assign(squared, Stealth::Tensor::hadamard(region, region))
+        );
+        int numIncorrect = 0;
+        for (int k = 0; k < doubled.height(); ++k) {
+            for (int j = 0; j < doubled.length(); ++j) {
+                for (int i = 0; i < doubled.width(); ++i) {
+                    numIncorrect += doubled(i, j, k) != region(i, j, k) * 2.0f;
+                    numIncorrect += squared(i, j, k) != region(i, j, k) * region(i, j, k);
+                }
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Fused */
+
+bool testFused() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Fused::testFuse);
+    allTestsPassed &= runTest(Fused::testFuseBlocks);
+    return allTestsPassed;
+}
+
+namespace Dirty {
+    TestResult testWriteTracking() {
+        Stealth::Tensor::TrackedTensor3<float, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> dirtyTest0
+            = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        dirtyTest0.clearDirty();
+        // Reading through an expression must not mark anything.
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> copy = dirtyTest0 + 1.0f;
+        int numIncorrect = !dirtyTest0.dirtyRegion().empty();
+        // Write a single element and a block.
+        dirtyTest0(2, 3, 4) = 0.0f;
+        Stealth::Tensor::block<4, 4>(dirtyTest0, 20, 20, 7) = 1.0f;
+        const Stealth::Tensor::Region region = dirtyTest0.dirtyRegion();
+        numIncorrect += !dirtyTest0.isDirty(2, 3, 4) or !dirtyTest0.isDirty(23, 23, 7) or dirtyTest0.isDirty(2, 3, 5);
+        numIncorrect += region.minZ != 4 or region.maxZ != 8 or region.minX != 0 or region.maxX != kTEST_WIDTH;
+        numIncorrect += dirtyTest0(21, 22, 7) != 1.0f;
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testEvalDirty() {
+        constexpr int kSTENCIL_WIDTH = kTEST_WIDTH - 2, kSTENCIL_LENGTH = kTEST_LENGTH - 2;
+        Stealth::Tensor::TrackedTensor3<float, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> dirtyTest0
+            = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        // A derived map that reads neighbouring tiles through offset blocks.
+        auto derived = Stealth::Tensor::block<kSTENCIL_WIDTH, kSTENCIL_LENGTH, kTEST_HEIGHT>(dirtyTest0, 2, 2)
+            + Stealth::Tensor::block<kSTENCIL_WIDTH, kSTENCIL_LENGTH, kTEST_HEIGHT>(dirtyTest0, 0, 0);
+        Stealth::Tensor::Tensor3F<kSTENCIL_WIDTH, kSTENCIL_LENGTH, kTEST_HEIGHT> result = derived;
+        dirtyTest0.clearDirty();
+        dirtyTest0(kTEST_WIDTH - 1, kTEST_LENGTH - 1, 3) = -1000.0f;
+        dirtyTest0(0, 0, 5) = -1000.0f;
+        Stealth::Tensor::evalDirty(result, derived, dirtyTest0);
+        Stealth::Tensor::Tensor3F<kSTENCIL_WIDTH, kSTENCIL_LENGTH, kTEST_HEIGHT> expected = derived;
+        int numIncorrect = 0;
+        for (int i = 0; i < result.size(); ++i) {
+            numIncorrect += result(i) != expected(i);
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Dirty */
+
+bool testDirty() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Dirty::testWriteTracking);
+    allTestsPassed &= runTest(Dirty::testEvalDirty);
+    return allTestsPassed;
+}
+
+namespace Rewrite {
+    TestResult testFoldConstants() {
+        Stealth::Tensor::Tensor3I<kTEST_WIDTH, kTEST_LENGTH> rewriteTest0;
+        for (int i = 0; i < rewriteTest0.size(); ++i) {
+            rewriteTest0(i) = i;
+        }
+        auto folded = ((rewriteTest0 + 2) + 3) * 2 * 4;
+        // Both constants are folded away, leaving a single add and a single multiply.
+        static_assert(std::is_same<decltype(folded), decltype((rewriteTest0 + 5) * 8)>::value);
+        Stealth::Tensor::Tensor3I<kTEST_WIDTH, kTEST_LENGTH> result = folded;
+        Stealth::Tensor::Tensor3I<kTEST_WIDTH, kTEST_LENGTH> difference = (rewriteTest0 - 2) - 3;
+        int numIncorrect = 0;
+        for (int i = 0; i < result.size(); ++i) {
+            numIncorrect += result(i) != (i + 5) * 8;
+            numIncorrect += difference(i) != i - 5;
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testCollapseBlocks() {
+        auto rewriteTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        auto outer = Stealth::Tensor::block<10, 10, 10>(rewriteTest0, 1, 2, 3);
+        auto inner = Stealth::Tensor::block<4, 4, 4>(outer, 2, 2, 2);
+        // The nested block refers straight to the Tensor3.
+        static_assert(std::is_same<decltype(inner), decltype(Stealth::Tensor::block<4, 4, 4>(rewriteTest0))>::value);
+        auto fromTemporary = Stealth::Tensor::block<4, 4, 4>(Stealth::Tensor::block<10, 10, 10>(rewriteTest0 * 2.0f, 1, 2, 3), 2, 2, 2);
+        int numIncorrect = 0;
+        for (int k = 0; k < inner.height(); ++k) {
+            for (int j = 0; j < inner.length(); ++j) {
+                for (int i = 0; i < inner.width(); ++i) {
+                    numIncorrect += inner(i, j, k) != rewriteTest0(i + 3, j + 4, k + 5);
+                    numIncorrect += fromTemporary(i, j, k) != rewriteTest0(i + 3, j + 4, k + 5) * 2.0f;
+                }
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testRemoveIdentities() {
+        auto rewriteTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        Stealth::Tensor::Tensor3<bool, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> mask = rewriteTest0 > 100.0f;
+        // Double negation of a boolean expression is the expression itself.
+        static_assert(std::is_same<decltype(!!mask), decltype(mask)&>::value);
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> product = rewriteTest0 * 1.0f;
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> difference = rewriteTest0 - 0.0f;
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> notIdentity = rewriteTest0 * 3.0f;
+        int numIncorrect = 0;
+        for (int i = 0; i < rewriteTest0.size(); ++i) {
+            numIncorrect += product(i) != rewriteTest0(i);
+            numIncorrect += difference(i) != rewriteTest0(i);
+            numIncorrect += notIdentity(i) != rewriteTest0(i) * 3.0f;
+            numIncorrect += (!!mask)(i) != (rewriteTest0(i) > 100.0f);
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Rewrite */
+
+bool testRewrite() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Rewrite::testFoldConstants);
+    allTestsPassed &= runTest(Rewrite::testCollapseBlocks);
+    allTestsPassed &= runTest(Rewrite::testRemoveIdentities);
+    return allTestsPassed;
+}
+
+namespace Tiles {
+    struct Elevation {
+        using ScalarType = float;
+    };
+
+    struct Temperature {
+        using ScalarType = float;
+    };
+
+    struct Biome : Stealth::Tensor::StringField { };
+
+    using TestTileMap = Stealth::Tensor::TileMap<kTEST_WIDTH, kTEST_LENGTH, 2, Elevation, Temperature, Biome>;
+
+    TestResult testFieldViews() {
+        auto tileMap = std::make_unique<TestTileMap>();
+        tileMap -> field<Elevation>() = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, 2>();
+        // Fields behave like any other Tensor3.
+        tileMap -> field<Temperature>() = 30.0f - tileMap -> field<Elevation>() / 10.0f;
+        Stealth::Tensor::block<4, 4>(tileMap -> field<Elevation>(), 2, 2, 1) = -1.0f;
+        auto [elevation, temperature, biome] = tileMap -> tile(3, 3, 1);
+        int numIncorrect = (elevation != -1.0f) + (biome != Stealth::Tensor::StringPool::kEMPTY);
+        temperature = 5.0f;
+        numIncorrect += tileMap -> field<Temperature>()(3, 3, 1) != 5.0f;
+        numIncorrect += tileMap -> field<Temperature>()(1, 0, 0) != 30.0f - 0.1f;
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testStringPool() {
+        auto tileMap = std::make_unique<TestTileMap>();
+        for (int y = 0; y < tileMap -> length(); ++y) {
+            for (int x = 0; x < tileMap -> width(); ++x) {
+                tileMap -> setString<Biome>(x < y ? "water" : "grass", x, y);
+            }
+        }
+        const auto water = tileMap -> strings().find("water");
+        // Strings are deduplicated, so comparing whole fields is an integer comparison.
+        Stealth::Tensor::Tensor3<bool, kTEST_WIDTH, kTEST_LENGTH, 2> isWater = tileMap -> field<Biome>() == water;
+        int numIncorrect = (tileMap -> strings().size() != 3) + (tileMap -> strings().find("lava") != Stealth::Tensor::StringPool::kNOT_FOUND);
+        for (int y = 0; y < tileMap -> length(); ++y) {
+            for (int x = 0; x < tileMap -> width(); ++x) {
+                numIncorrect += isWater(x, y, 0) != (x < y);
+                numIncorrect += tileMap -> string<Biome>(x, y) != (x < y ? "water" : "grass");
+                // The second layer was never written.
+                numIncorrect += !tileMap -> string<Biome>(x, y, 1).empty();
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Tiles */
+
+bool testTiles() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Tiles::testFieldViews);
+    allTestsPassed &= runTest(Tiles::testStringPool);
+    return allTestsPassed;
+}
+
+namespace Labels {
+    // Reference labelling by breadth-first flood fill, numbering components in raster order.
+    template <typename Source, typename Offsets>
+    std::vector<int> floodFill(const Source& source, const Offsets& offsets) {
+        const int width = source.width(), length = source.length(), height = source.height();
+        std::vector<int> labels(source.size(), -1);
+        int numLabels = 0;
+        for (int start = 0; start < source.size(); ++start) {
+            if (labels[start] != -1) continue;
+            std::vector<int> frontier{start};
+            labels[start] = numLabels;
+            while (!frontier.empty()) {
+                const int current = frontier.back();
+                frontier.pop_back();
+                const int x = current % width, y = current / width % length, z = current / (width * length);
+                for (const auto& offset : offsets) {
+                    const int nx = x + offset[0], ny = y + offset[1], nz = z + offset[2];
+                    if (nx < 0 or nx >= width or ny < 0 or ny >= length or nz < 0 or nz >= height) continue;
+                    const int neighbour = nx + ny * width + nz * width * length;
+                    if (labels[neighbour] == -1 and source(neighbour) == source(current)) {
+                        labels[neighbour] = numLabels;
+                        frontier.push_back(neighbour);
+                    }
+                }
+            }
+            ++numLabels;
+        }
+        return labels;
+    }
+
+    // Large enough to span several labelling blocks.
+    template <int width, int length, int height>
+    auto noisyMap() {
+        auto map = std::make_unique<Stealth::Tensor::Tensor3I<width, length, height>>();
+        *map = RandomTensor3I<width, length, height>(12345, 3) == 0;
+        return map;
+    }
+
+    template <Stealth::Tensor::Connectivity connectivity, typename Source, typename Offsets>
+    int countMismatches(const Source& source, const Offsets& offsets) {
+        const auto labeling = Stealth::Tensor::connectedComponents<connectivity>(source);
+        const std::vector<int> expected = floodFill(source, offsets);
+        int numIncorrect = 0;
+        std::vector<int> sizes(labeling.numLabels(), 0);
+        for (int i = 0; i < source.size(); ++i) {
+            numIncorrect += labeling.labels(i) != expected[i];
+            ++sizes[expected[i]];
+        }
+        numIncorrect += sizes != labeling.sizes;
+        return numIncorrect;
+    }
+
+    TestResult testLabel2D() {
+        const auto map = noisyMap<150, 130, 2>();
+        const std::vector<std::array<int, 3>> four{{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}};
+        std::vector<std::array<int, 3>> eight;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                if (dx or dy) eight.push_back({dx, dy, 0});
+            }
+        }
+        int numIncorrect = countMismatches<Stealth::Tensor::Connectivity::Four>(*map, four);
+        numIncorrect += countMismatches<Stealth::Tensor::Connectivity::Eight>(*map, eight);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testLabel3D() {
+        const auto map = noisyMap<70, 70, 20>();
+        const std::vector<std::array<int, 3>> six{{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+        std::vector<std::array<int, 3>> twentySix;
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    if (dx or dy or dz) twentySix.push_back({dx, dy, dz});
+                }
+            }
+        }
+        int numIncorrect = countMismatches<Stealth::Tensor::Connectivity::Six>(*map, six);
+        numIncorrect += countMismatches<Stealth::Tensor::Connectivity::TwentySix>(*map, twentySix);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testLabelPredicate() {
+        auto labelTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH>();
+        // Neighbours within one of each other are joined, which links each row but not the rows together.
+        const auto labeling = Stealth::Tensor::connectedComponents(labelTest0,
+            [](float a, float b) { return std::abs(a - b) <= 1.0f; });
+        int numIncorrect = labeling.numLabels() != kTEST_LENGTH;
+        for (int y = 0; y < kTEST_LENGTH; ++y) {
+            numIncorrect += labeling.labels(kTEST_WIDTH - 1, y) != y or labeling.sizes[y] != kTEST_WIDTH;
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Labels */
+
+bool testLabels() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Labels::testLabel2D);
+    allTestsPassed &= runTest(Labels::testLabel3D);
+    allTestsPassed &= runTest(Labels::testLabelPredicate);
+    return allTestsPassed;
+}
+
+namespace Distance {
+    template <Stealth::Tensor::Metric metric>
+    double bruteForceDistance(int dx, int dy, int dz) {
+        dx = std::abs(dx); dy = std::abs(dy); dz = std::abs(dz);
+        if constexpr (metric == Stealth::Tensor::Metric::Manhattan) return dx + dy + dz;
+        else if constexpr (metric == Stealth::Tensor::Metric::Chebyshev) return std::max({dx, dy, dz});
+        else return std::sqrt(static_cast<double>(dx * dx + dy * dy + dz * dz));
+    }
+
+    // Compares against the nearest wall found by checking every wall.
+    template <Stealth::Tensor::Metric metric, bool acrossLayers, typename Map>
+    int countMismatches(const Map& map) {
+        Stealth::Tensor::Tensor3D<Map::width(), Map::length(), Map::height()> distances;
+        Stealth::Tensor::distanceTransform<metric, acrossLayers>(distances, map == 1);
+        int numIncorrect = 0;
+        for (int z = 0; z < map.height(); ++z) {
+            for (int y = 0; y < map.length(); ++y) {
+                for (int x = 0; x < map.width(); ++x) {
+                    double expected = std::numeric_limits<double>::infinity();
+                    for (int k = acrossLayers ? 0 : z; k < (acrossLayers ? map.height() : z + 1); ++k) {
+                        for (int j = 0; j < map.length(); ++j) {
+                            for (int i = 0; i < map.width(); ++i) {
+                                if (map(i, j, k) == 1) expected = std::min(expected, bruteForceDistance<metric>(x - i, y - j, z - k));
+                            }
+                        }
+                    }
+                    numIncorrect += distances(x, y, z) != expected;
+                }
+            }
+        }
+        return numIncorrect;
+    }
+
+    template <int width, int length, int height>
+    Stealth::Tensor::Tensor3I<width, length, height> sparseWalls() {
+        return RandomTensor3I<width, length, height>(777, 50) == 0;
+    }
+
+    TestResult testDistanceLayers() {
+        auto distanceTest0 = sparseWalls<40, 30, 3>();
+        // Leave one layer without walls.
+        Stealth::Tensor::block<40, 30, 1>(distanceTest0, 0, 0, 2) = 0;
+        int numIncorrect = countMismatches<Stealth::Tensor::Metric::Manhattan, false>(distanceTest0);
+        numIncorrect += countMismatches<Stealth::Tensor::Metric::Chebyshev, false>(distanceTest0);
+        numIncorrect += countMismatches<Stealth::Tensor::Metric::Euclidean, false>(distanceTest0);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testDistanceVolume() {
+        const auto distanceTest0 = sparseWalls<20, 18, 12>();
+        int numIncorrect = countMismatches<Stealth::Tensor::Metric::Manhattan, true>(distanceTest0);
+        numIncorrect += countMismatches<Stealth::Tensor::Metric::Chebyshev, true>(distanceTest0);
+        numIncorrect += countMismatches<Stealth::Tensor::Metric::Euclidean, true>(distanceTest0);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testSquaredDistanceInts() {
+        Stealth::Tensor::MatrixI<kTEST_WIDTH, kTEST_LENGTH> distanceTest0{};
+        distanceTest0(0, 0) = 1;
+        Stealth::Tensor::MatrixI<kTEST_WIDTH, kTEST_LENGTH> distances;
+        Stealth::Tensor::distanceTransform<Stealth::Tensor::Metric::SquaredEuclidean>(distances, distanceTest0);
+        int numIncorrect = 0;
+        for (int y = 0; y < kTEST_LENGTH; ++y) {
+            for (int x = 0; x < kTEST_WIDTH; ++x) {
+                numIncorrect += distances(x, y) != x * x + y * y;
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Distance */
+
+bool testDistance() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Distance::testDistanceLayers);
+    allTestsPassed &= runTest(Distance::testDistanceVolume);
+    allTestsPassed &= runTest(Distance::testSquaredDistanceInts);
+    return allTestsPassed;
+}
+
+namespace Flow {
+    // Reference integration field from a plain Dijkstra over the four neighbours within each layer.
+    template <typename Costs>
+    std::vector<int> referenceIntegration(const Costs& costs, const std::vector<std::array<int, 3>>& goals) {
+        const int width = costs.width(), length = costs.length();
+        std::vector<int> distances(costs.size(), std::numeric_limits<int>::max());
+        std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>, std::greater<>> queue;
+        for (const auto& goal : goals) {
+            const int index = goal[0] + width * (goal[1] + length * goal[2]);
+            distances[index] = 0;
+            queue.emplace(0, index);
+        }
+        const int offsets[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+        while (!queue.empty()) {
+            const auto [distance, index] = queue.top();
+            queue.pop();
+            if (distance != distances[index]) continue;
+            const int x = index % width, y = index / width % length, z = index / (width * length);
+            for (const auto& offset : offsets) {
+                const int nx = x + offset[0], ny = y + offset[1];
+                if (nx < 0 or nx >= width or ny < 0 or ny >= length or costs(nx, ny, z) < 1) continue;
+                const int neighbour = nx + width * (ny + length * z);
+                if (distance + costs(nx, ny, z) < distances[neighbour]) {
+                    distances[neighbour] = distance + costs(nx, ny, z);
+                    queue.emplace(distances[neighbour], neighbour);
+                }
+            }
+        }
+        return distances;
+    }
+
+    // Compares integration against the reference, and checks that every direction steps to a tile
+    // that is exactly the cost of this one closer to a goal.
+    template <typename Field, typename Costs>
+    int countMismatches(const Field& field, const Costs& costs) {
+        const std::vector<int> expected = referenceIntegration(costs, field.goals());
+        int numIncorrect = 0;
+        for (int z = 0; z < costs.height(); ++z) {
+            for (int y = 0; y < costs.length(); ++y) {
+                for (int x = 0; x < costs.width(); ++x) {
+                    const int integration = field.integration()(x, y, z);
+                    numIncorrect += integration != expected[x + costs.width() * (y + costs.length() * z)];
+                    const auto next = field.next(x, y, z);
+                    if (field.directions()(x, y, z) >= 0) {
+                        numIncorrect += field.integration()(next[0], next[1], next[2]) + costs(x, y, z) != integration;
+                    } else if (field.directions()(x, y, z) == Field::kBLOCKED) {
+                        numIncorrect += integration != Field::kUNREACHABLE;
+                    }
+                }
+            }
+        }
+        return numIncorrect;
+    }
+
+    template <int width, int length, int height = 1>
+    Stealth::Tensor::Tensor3I<width, length, height> randomCosts() {
+        auto costs = RandomTensor3I<width, length, height>(4242, 72);
+        for (int i = 0; i < costs.size(); ++i) {
+            // Roughly one tile in eight is a wall, and the rest cost 1 to 9.
+            costs(i) = costs(i) % 8 == 0 ? 0 : 1 + costs(i) / 8;
+        }
+        return costs;
+    }
+
+    TestResult testFlowField() {
+        auto flowTest0 = randomCosts<60, 50, 2>();
+        const std::vector<std::array<int, 3>> goals{{0, 0, 0}, {59, 49, 0}, {30, 20, 1}};
+        const Stealth::Tensor::FlowField<60, 50, 2> field{flowTest0, goals};
+        const int numIncorrect = countMismatches(field, flowTest0);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testFlowFieldRepair() {
+        auto flowTest0 = randomCosts<60, 50>();
+        Stealth::Tensor::FlowField<60, 50> field{flowTest0, {{5, 5, 0}, {50, 40, 0}}};
+        // Wall off a region, then make another one cheaper.
+        auto wall = Stealth::Tensor::block<12, 3>(flowTest0, 20, 10);
+        wall = 0;
+        field.repair(flowTest0, wall);
+        int numIncorrect = countMismatches(field, flowTest0);
+        auto road = Stealth::Tensor::block<30, 1>(flowTest0, 10, 30);
+        road = 1;
+        field.repair(flowTest0, road);
+        numIncorrect += countMismatches(field, flowTest0);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Flow */
+
+bool testFlow() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Flow::testFlowField);
+    allTestsPassed &= runTest(Flow::testFlowFieldRepair);
+    return allTestsPassed;
+}
+
+namespace Layouts {
+    template <typename Layout>
+    using LayoutTensor3F = Stealth::Tensor::Tensor3<float, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT, Layout>;
+
+    template <typename Layout>
+    int countLayoutMismatches() {
+        const auto rowMajor = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        // Converting from another layout walks the destination brick by brick.
+        const LayoutTensor3F<Layout> layoutTest0 = rowMajor;
+        // Operands that share a layout are combined in storage order.
+        const LayoutTensor3F<Layout> layoutTest1 = layoutTest0 * 2.0f + layoutTest0;
+        // Mixed layouts and views fall back to coordinates.
+        const Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> mixed = layoutTest1 - rowMajor;
+        LayoutTensor3F<Layout> layoutTest2{};
+        Stealth::Tensor::block<kTEST_WIDTH - 4, 5, 2>(layoutTest2, 3, 7, 1) = Stealth::Tensor::block<kTEST_WIDTH - 4, 5, 2>(layoutTest0, 1, 2, 3);
+        int numIncorrect = 0;
+        for (int z = 0; z < kTEST_HEIGHT; ++z) {
+            for (int y = 0; y < kTEST_LENGTH; ++y) {
+                for (int x = 0; x < kTEST_WIDTH; ++x) {
+                    numIncorrect += layoutTest0(x, y, z) != rowMajor(x, y, z);
+                    numIncorrect += layoutTest1(x, y, z) != rowMajor(x, y, z) * 3.0f;
+                    numIncorrect += mixed(x, y, z) != rowMajor(x, y, z) * 2.0f;
+                    const bool inBlock = x >= 3 and x < kTEST_WIDTH - 1 and y >= 7 and y < 12 and z >= 1 and z < 3;
+                    numIncorrect += layoutTest2(x, y, z) != (inBlock ? rowMajor(x - 2, y - 5, z + 2) : 0.0f);
+                }
+            }
+        }
+        return numIncorrect;
+    }
+
+    TestResult testTiledLayout() {
+        int numIncorrect = countLayoutMismatches<Stealth::Tensor::Tiled<8, 8>>();
+        // Each 8x8 tile is contiguous, and the 30 wide tensor is padded to 4 tiles across.
+        LayoutTensor3F<Stealth::Tensor::Tiled<8, 8>> layoutTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        numIncorrect += layoutTest0.data()[8] != layoutTest0(0, 1, 0);
+        numIncorrect += layoutTest0.data()[64] != layoutTest0(8, 0, 0);
+        numIncorrect += layoutTest0.data()[4 * 4 * 64] != layoutTest0(0, 0, 1);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testMortonLayout() {
+        int numIncorrect = countLayoutMismatches<Stealth::Tensor::Morton>();
+        LayoutTensor3F<Stealth::Tensor::Morton> layoutTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        numIncorrect += layoutTest0.data()[1] != layoutTest0(1, 0, 0);
+        numIncorrect += layoutTest0.data()[2] != layoutTest0(0, 1, 0);
+        numIncorrect += layoutTest0.data()[3] != layoutTest0(1, 1, 0);
+        numIncorrect += layoutTest0.data()[32 * 32] != layoutTest0(0, 0, 1);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    // Integer division must never see the padding of a tiled layout, which is zero or uninitialized.
+    template <typename Layout, int width, int length>
+    int countPaddedDivisionMismatches() {
+        Stealth::Tensor::Tensor3<int, width, length, 2> rowMajor0, rowMajor1;
+        for (int i = 0; i < rowMajor0.size(); ++i) {
+            rowMajor0(i) = i + 100;
+            rowMajor1(i) = i % 7 + 1;
+        }
+        const Stealth::Tensor::Tensor3<int, width, length, 2, Layout> dividend = rowMajor0, divisor = rowMajor1;
+        const Stealth::Tensor::Tensor3<int, width, length, 2, Layout> quotient = dividend / divisor;
+        int numIncorrect = 0;
+        for (int z = 0; z < 2; ++z) {
+            for (int y = 0; y < length; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    numIncorrect += quotient(x, y, z) != rowMajor0(x, y, z) / rowMajor1(x, y, z);
+                }
+            }
+        }
+        return numIncorrect;
+    }
+
+    TestResult testPaddedLayouts() {
+        int numIncorrect = countPaddedDivisionMismatches<Stealth::Tensor::Tiled<8, 8>, 10, 10>();
+        numIncorrect += countPaddedDivisionMismatches<Stealth::Tensor::Tiled<8, 8>, 20, 16>();
+        numIncorrect += countPaddedDivisionMismatches<Stealth::Tensor::Morton, 10, 10>();
+        numIncorrect += countPaddedDivisionMismatches<Stealth::Tensor::Morton, 40, 12>();
+        numIncorrect += countPaddedDivisionMismatches<Stealth::Tensor::Morton, 12, 40>();
+        // Elongated layers are padded along each axis separately rather than to a square.
+        static_assert(Stealth::Tensor::Morton::kSTORAGE_SIZE<4096, 16, 1> == 4096 * 16, "Morton layers must not be padded to a square");
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    // Initializer lists are in x, then y, then z order whatever the layout.
+    template <typename Layout>
+    int countInitializerListMismatches() {
+        const Stealth::Tensor::Tensor3<int, 3, 3, 2, Layout> initialized = {
+            1, 2, 3, 4, 5, 6, 7, 8, 9,
+            10, 11, 12, 13, 14, 15, 16, 17
+        };
+        int numIncorrect = 0;
+        for (int z = 0; z < 2; ++z) {
+            for (int y = 0; y < 3; ++y) {
+                for (int x = 0; x < 3; ++x) {
+                    const int i = x + 3 * (y + 3 * z);
+                    numIncorrect += initialized(x, y, z) != (i < 17 ? i + 1 : 0);
+                }
+            }
+        }
+        return numIncorrect;
+    }
+
+    TestResult testLayoutInitializerLists() {
+        int numIncorrect = countInitializerListMismatches<Stealth::Tensor::Tiled<2, 2>>();
+        numIncorrect += countInitializerListMismatches<Stealth::Tensor::Morton>();
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Layouts */
+
+bool testLayouts() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Layouts::testTiledLayout);
+    allTestsPassed &= runTest(Layouts::testMortonLayout);
+    allTestsPassed &= runTest(Layouts::testPaddedLayouts);
+    allTestsPassed &= runTest(Layouts::testLayoutInitializerLists);
+    return allTestsPassed;
+}
+
+namespace Ring {
+    // Stands in for a world far larger than the view, generated on demand.
+    struct World {
+        int originX = 0, originY = 0;
+
+        float operator()(int x, int y, int z) const {
+            return static_cast<float>((originX + x) * 1000 + (originY + y) * 10 + z);
+        }
+    };
+
+    template <typename RingTensor>
+    int countViewMismatches(const RingTensor& view, const World& world) {
+        int numIncorrect = 0;
+        for (int z = 0; z < 3; ++z) {
+            for (int y = 0; y < kTEST_LENGTH; ++y) {
+                for (int x = 0; x < kTEST_WIDTH; ++x) {
+                    numIncorrect += view(x, y, z) != world(x, y, z);
+                }
+            }
+        }
+        return numIncorrect;
+    }
+
+    TestResult testScroll() {
+        World world{};
+        Stealth::Tensor::RingTensor3<float, kTEST_WIDTH, kTEST_LENGTH, 3> ringTest0{};
+        ringTest0.fill(Stealth::Tensor::Region{0, 0, 0, kTEST_WIDTH, kTEST_LENGTH, 3}, world);
+        int numIncorrect = countViewMismatches(ringTest0, world);
+        // Diagonal, backwards, past the storage edge, and further than the whole view.
+        const std::array<std::array<int, 2>, 5> moves{{{3, 5}, {-7, 2}, {0, -11}, {kTEST_WIDTH - 1, 0}, {-kTEST_WIDTH - 4, 40}}};
+        for (int i = 0; i < static_cast<int>(moves.size()); ++i) {
+            world.originX += moves[i][0];
+            world.originY += moves[i][1];
+            ringTest0.scroll(moves[i][0], moves[i][1], 0, world);
+            numIncorrect += countViewMismatches(ringTest0, world);
+        }
+        // Only the edge that scrolled into view is exposed, once.
+        const auto exposed = ringTest0.scroll(2, -3);
+        int numExposed = 0;
+        for (int i = 0; i < static_cast<int>(exposed.size()); ++i) {
+            const auto& region = exposed[i];
+            if (not region.empty()) numExposed += (region.maxX - region.minX) * (region.maxY - region.minY) * (region.maxZ - region.minZ);
+        }
+        numIncorrect += numExposed != (2 * kTEST_LENGTH + 3 * (kTEST_WIDTH - 2)) * 3;
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testRingExpressions() {
+        World world{};
+        Stealth::Tensor::RingTensor3<float, kTEST_WIDTH, kTEST_LENGTH, 3> ringTest0{};
+        ringTest0.fill(Stealth::Tensor::Region{0, 0, 0, kTEST_WIDTH, kTEST_LENGTH, 3}, world);
+        world.originX -= 13;
+        world.originY += 17;
+        ringTest0.scroll(-13, 17, 0, world);
+        // Plain assignment unwraps the ring.
+        const Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, 3> unwrapped = ringTest0;
+        const Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, 3> doubled = ringTest0 * 2.0f;
+        const Stealth::Tensor::Tensor3F<4, 4, 1> corner = Stealth::Tensor::block<4, 4, 1>(ringTest0, kTEST_WIDTH - 2, 1, 2);
+        int numIncorrect = 0;
+        for (int z = 0; z < 3; ++z) {
+            for (int y = 0; y < kTEST_LENGTH; ++y) {
+                for (int x = 0; x < kTEST_WIDTH; ++x) {
+                    numIncorrect += unwrapped(x, y, z) != world(x, y, z);
+                    numIncorrect += doubled(x, y, z) != world(x, y, z) * 2.0f;
+                }
+            }
+        }
+        for (int y = 0; y < 4; ++y) {
+            for (int x = 0; x < 2; ++x) {
+                numIncorrect += corner(x, y, 0) != world(kTEST_WIDTH - 2 + x, 1 + y, 2);
+            }
+        }
+        // Scalars fill a region in place.
+        ringTest0.fill(Stealth::Tensor::Region{kTEST_WIDTH - 5, 0, 0, kTEST_WIDTH, 2, 1}, -1.0f);
+        numIncorrect += ringTest0(kTEST_WIDTH - 1, 1, 0) != -1.0f;
+        numIncorrect += ringTest0(kTEST_WIDTH - 6, 1, 0) != world(kTEST_WIDTH - 6, 1, 0);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Ring */
+
+bool testRing() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Ring::testScroll);
+    allTestsPassed &= runTest(Ring::testRingExpressions);
+    return allTestsPassed;
+}
+
+namespace Compressed {
+    using TileMap = Stealth::Tensor::Tensor3<int, kTEST_WIDTH, kTEST_LENGTH, 3>;
+
+    // A uniform layer, a layer of short horizontal runs with many values and a noisy layer with few values.
+    TileMap makeTiles() {
+        TileMap tiles{};
+        for (int y = 0; y < kTEST_LENGTH; ++y) {
+            for (int x = 0; x < kTEST_WIDTH; ++x) {
+                tiles(x, y, 0) = 7;
+                tiles(x, y, 1) = x / 4 + 10 * y;
+                tiles(x, y, 2) = (x * 7 + y * 13) % 5;
+            }
+        }
+        return tiles;
+    }
+
+    template <typename Compressed>
+    int countMismatches(const Compressed& compressed, const TileMap& tiles) {
+        // Tensor3 assignment decodes rows, while expressions decode single elements.
+        const TileMap decoded = compressed;
+        const TileMap incremented = compressed + 1;
+        int numIncorrect = 0;
+        for (int z = 0; z < 3; ++z) {
+            for (int y = 0; y < kTEST_LENGTH; ++y) {
+                for (int x = 0; x < kTEST_WIDTH; ++x) {
+                    numIncorrect += compressed(x, y, z) != tiles(x, y, z);
+                    numIncorrect += decoded(x, y, z) != tiles(x, y, z);
+                    numIncorrect += incremented(x, y, z) != tiles(x, y, z) + 1;
+                }
+            }
+        }
+        return numIncorrect;
+    }
+
+    TestResult testCompressedRoundTrip() {
+        const TileMap tiles = makeTiles();
+        const Stealth::Tensor::CompressedTensor3<int, kTEST_WIDTH, kTEST_LENGTH, 3> compressedTest0 = tiles;
+        int numIncorrect = countMismatches(compressedTest0, tiles);
+        numIncorrect += not compressedTest0.chunk(0, 0, 1).isRunLength();
+        numIncorrect += compressedTest0.chunk(0, 0, 2).isRunLength();
+        numIncorrect += compressedTest0.bytes() >= sizeof(int) * tiles.size();
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testCompressedWriteBack() {
+        TileMap tiles = makeTiles();
+        Stealth::Tensor::CompressedTensor3<int, kTEST_WIDTH, kTEST_LENGTH, 3> compressedTest0 = tiles;
+        // Writes land in two chunks, one of them with a value outside its palette.
+        compressedTest0(3, 4, 0) = tiles(3, 4, 0) = -5;
+        compressedTest0(kTEST_WIDTH - 1, kTEST_LENGTH - 1, 2) = tiles(kTEST_WIDTH - 1, kTEST_LENGTH - 1, 2) = 2;
+        compressedTest0(kTEST_WIDTH - 2, kTEST_LENGTH - 1, 2) = tiles(kTEST_WIDTH - 2, kTEST_LENGTH - 1, 2) = 4;
+        int numIncorrect = compressedTest0.numDirtyChunks() != 2;
+        numIncorrect += countMismatches(std::as_const(compressedTest0), tiles);
+        compressedTest0.flush();
+        numIncorrect += compressedTest0.numDirtyChunks() != 0;
+        numIncorrect += countMismatches(std::as_const(compressedTest0), tiles);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testCompressedExpressionReads() {
+        TileMap tiles = makeTiles();
+        const TileMap doubledTiles = tiles * 2;
+        Stealth::Tensor::CompressedTensor3<int, kTEST_WIDTH, kTEST_LENGTH, 3> compressedTest0 = tiles, compressedTest1 = doubledTiles;
+        // Both operands are decoded element by element, in turn.
+        TileMap sum = std::as_const(compressedTest0) + std::as_const(compressedTest1);
+        int numIncorrect = 0;
+        for (int i = 0; i < sum.size(); ++i) {
+            numIncorrect += sum(i) != tiles(i) * 3;
+        }
+        // Expressions must see chunks that were re-encoded since they were last read.
+        numIncorrect += std::as_const(compressedTest0)(5, 6, 1) != tiles(5, 6, 1);
+        compressedTest0(5, 6, 1) = tiles(5, 6, 1) = -1;
+        compressedTest0.flush();
+        numIncorrect += not compressedTest0.chunk(5, 6, 1).isRunLength();
+        numIncorrect += std::as_const(compressedTest0)(5, 6, 1) != -1;
+        sum = std::as_const(compressedTest0) + std::as_const(compressedTest1);
+        for (int i = 0; i < sum.size(); ++i) {
+            numIncorrect += sum(i) != tiles(i) + doubledTiles(i);
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Compressed */
+
+bool testCompressed() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Compressed::testCompressedRoundTrip);
+    allTestsPassed &= runTest(Compressed::testCompressedWriteBack);
+    allTestsPassed &= runTest(Compressed::testCompressedExpressionReads);
+    return allTestsPassed;
+}
+
+namespace Dispatch {
+    using Stealth::Tensor::InstructionSet;
+
+    template <typename Tensor3>
+    int countMismatches(const Tensor3& actual, const Tensor3& expected) {
+        int numIncorrect = 0;
+        for (int i = 0; i < expected.size(); ++i) {
+            numIncorrect += actual(i) != expected(i);
+        }
+        return numIncorrect;
+    }
+
+    TestResult testInstructionSets() {
+        const InstructionSet initial = Stealth::Tensor::currentInstructionSet();
+        const auto dispatchTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        const auto dispatchTest1 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>(7);
+        Stealth::Tensor::setInstructionSet(InstructionSet::Baseline);
+        const Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> expected = dispatchTest0 * 0.1f + dispatchTest1 * 0.7f;
+        const Stealth::Tensor::Tensor3F<10, 10, 10> expectedBlock = Stealth::Tensor::block<10, 10, 10>(expected, 3, 4, 5) - 1.0f;
+        int numIncorrect = 0;
+        // Every path this machine can run must agree with the baseline. The multipliers are inexact, so a
+        // contracted multiply-add would round differently.
+        const std::array<InstructionSet, 3> instructionSets{{InstructionSet::Baseline, InstructionSet::AVX2, InstructionSet::AVX512}};
+        for (int i = 0; i < static_cast<int>(instructionSets.size()); ++i) {
+            const InstructionSet selected = Stealth::Tensor::setInstructionSet(instructionSets[i]);
+            const bool supported = static_cast<int>(instructionSets[i]) <= static_cast<int>(Stealth::Tensor::supportedInstructionSet());
+            numIncorrect += supported ? selected != instructionSets[i] : selected != Stealth::Tensor::supportedInstructionSet();
+            const Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> result = dispatchTest0 * 0.1f + dispatchTest1 * 0.7f;
+            const Stealth::Tensor::Tensor3F<10, 10, 10> resultBlock = Stealth::Tensor::block<10, 10, 10>(result, 3, 4, 5) - 1.0f;
+            numIncorrect += countMismatches(result, expected) + countMismatches(resultBlock, expectedBlock);
+        }
+        Stealth::Tensor::setInstructionSet(initial);
+        numIncorrect += Stealth::Tensor::internal::parse_instruction_set("avx2", InstructionSet::Baseline) != InstructionSet::AVX2;
+        numIncorrect += Stealth::Tensor::internal::parse_instruction_set("sse9", InstructionSet::AVX512) != InstructionSet::AVX512;
+        numIncorrect += Stealth::Tensor::internal::parse_instruction_set(nullptr, InstructionSet::AVX2) != InstructionSet::AVX2;
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Dispatch */
+
+bool testDispatch() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Dispatch::testInstructionSets);
+    return allTestsPassed;
+}
+
+namespace Indexing {
+    // Exactly 2^31 elements, one more than int can index. Storage is zero pages from calloc, so only the pages
+    // touched here are ever backed by memory.
+    using LargeTensor3 = Stealth::Tensor::Tensor3<unsigned char, 2048, 2048, 512>;
+
+    static_assert(std::is_same<Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>::IndexType, int>::value,
+        "Small tensors must keep int indices");
+    static_assert(std::is_same<LargeTensor3::IndexType, std::int64_t>::value, "Large tensors must use 64-bit indices");
+    static_assert(Stealth::Tensor::internal::traits<LargeTensor3>::indexingMode == 2, "Large tensors must be evaluated by rows");
+
+    TestResult testFlatRanges() {
+        // Every element of a range beyond INT_MAX must be handed out exactly once.
+        const std::int64_t size = (std::int64_t{1} << 31) + 5;
+        std::atomic<std::int64_t> total{0}, last{0};
+        Stealth::Tensor::internal::parallel_for_flat(size, Stealth::Tensor::internal::kPARALLEL_GRAIN_SIZE,
+            [size, &total, &last](std::int64_t begin, std::int64_t end) {
+                total += end - begin;
+                if (end == size) last = begin;
+            });
+        const bool passed = total == size and last > std::numeric_limits<int>::max();
+        return TestResult{passed, "Covered " + std::to_string(total) + " of " + std::to_string(size) + " elements."};
+    }
+
+    TestResult testLargeTensor() {
+        LargeTensor3 tensor{};
+        int numIncorrect = 0;
+        tensor(2047, 2047, 511) = 7;
+        // Every accessor must reach the last element.
+        numIncorrect += tensor.data() + (std::int64_t{1} << 31) - 1 != &tensor(2047, 2047, 511);
+        numIncorrect += &tensor(2047, 2047 + 511 * 2048) != &tensor(2047, 2047, 511);
+        numIncorrect += &tensor((std::int64_t{1} << 31) - 1) != &tensor(2047, 2047, 511);
+        // Blocks at the far corner address the tensor by coordinates.
+        Stealth::Tensor::block<4, 4, 1>(tensor, 2044, 2044, 511) = Stealth::Tensor::block<4, 4, 1>(tensor, 2044, 2044, 511) + 1;
+        const Stealth::Tensor::Tensor3<unsigned char, 4, 4, 1> corner = Stealth::Tensor::block<4, 4, 1>(tensor, 2044, 2044, 511);
+        for (int i = 0; i < corner.size(); ++i) {
+            numIncorrect += corner(i) != (i == corner.size() - 1 ? 8 : 1);
+        }
+        numIncorrect += tensor(2043, 2047, 511) != 0 or tensor(0, 0, 0) != 0;
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    // Evaluates whole expressions across the INT_MAX boundary, so unlike the test above every page is touched.
+    TestResult testLargeExpressions() {
+        LargeTensor3 tensor{};
+        Stealth::Tensor::Tensor3<unsigned char, 2048, 2048, 1> plane{};
+        plane(5, 0, 0) = 1;
+        plane(2047, 2047, 0) = 3;
+        tensor(2047, 2047, 511) = 4;
+        // Evaluated by rows, with the plane broadcast over every layer.
+        tensor = tensor + plane;
+        int numIncorrect = 0;
+        for (int z : {0, 255, 511}) {
+            for (int x = 0; x < 2048; ++x) {
+                numIncorrect += tensor(x, 0, z) != (x == 5 ? 1 : 0);
+                numIncorrect += tensor(x, 2047, z) != (x == 2047 ? (z == 511 ? 7 : 3) : 0);
+            }
+        }
+        // Matches past INT_MAX must keep their flat indices.
+        const auto indices = Stealth::Tensor::nonzero(tensor == 7);
+        static_assert(std::is_same<decltype(indices), const std::vector<std::int64_t>>::value,
+            "Large tensors must be compacted with 64-bit indices");
+        numIncorrect += indices != std::vector<std::int64_t>{(std::int64_t{1} << 31) - 1};
+        numIncorrect += Stealth::Tensor::find(tensor == 7) != std::vector<std::array<int, 3>>{{{2047, 2047, 511}}};
+        const auto compacted = Stealth::Tensor::compact(tensor == 1, tensor);
+        numIncorrect += compacted.indices.size() != 512 or compacted.values != std::vector<unsigned char>(512, 1);
+        for (int z = 0; z < static_cast<int>(std::min<std::size_t>(512, compacted.indices.size())); ++z) {
+            numIncorrect += compacted.indices[z] != 5 + z * (std::int64_t{2048} * 2048);
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+} /* Indexing */
+
+bool testIndexing() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Indexing::testFlatRanges);
+    allTestsPassed &= runTest(Indexing::testLargeTensor);
+    allTestsPassed &= runTest(Indexing::testLargeExpressions);
+    return allTestsPassed;
+}
+
+namespace Executors {
+    // Counts the ranges it is handed, and runs them serially.
+    class CountingExecutor : public Stealth::Tensor::Executor {
+        public:
+            void parallelFor(int begin, int end, int grain, Stealth::Tensor::RangeFunction body) override {
+                for (int chunkBegin = begin; chunkBegin < end; chunkBegin += grain) {
+                    body(chunkBegin, std::min(end, chunkBegin + grain));
+                    ++numRanges;
+                }
+            }
+
+            int numRanges = 0;
+    };
+
+    TestResult testWorkStealing() {
+        auto executorTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        Stealth::Tensor::WorkStealingExecutor pool{4};
+        Stealth::Tensor::ExecutorScope scope{pool};
+        int numIncorrect = 0;
+        // Run several evaluations through the same pool to exercise worker reuse.
+        for (int iteration = 0; iteration < 10; ++iteration) {
+            Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> sum = executorTest0 + float(iteration);
+            auto flipped = Stealth::Tensor::reverse<true, true, true>(executorTest0).eval();
+            for (int i = 0; i < sum.size(); ++i) {
+                numIncorrect += sum(i) != executorTest0(i) + iteration;
+                numIncorrect += flipped(i) != executorTest0(sum.size() - 1 - i);
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testCustomExecutor() {
+        auto executorTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        CountingExecutor counter;
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> doubled;
+        {
+            Stealth::Tensor::ExecutorScope scope{counter};
+            doubled = executorTest0 * 2.0f;
+        }
+        int numIncorrect = (counter.numRanges == 0);
+        for (int i = 0; i < doubled.size(); ++i) {
+            numIncorrect += doubled(i) != executorTest0(i) * 2.0f;
+        }
+        // Outside the scope, the default executor is used again.
+        const int numRanges = counter.numRanges;
+        doubled = executorTest0 * 3.0f;
+        numIncorrect += (counter.numRanges != numRanges);
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testExecutorCoverage() {
+        // Scans, tables, pyramids and scatters must all go through the installed executor.
+        auto executorTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        Stealth::Tensor::Tensor3I<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> positions{};
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> scanned;
+        Stealth::Tensor::VectorI<8> density{};
+        CountingExecutor counter;
+        Stealth::Tensor::ExecutorScope scope{counter};
+        int numIncorrect = 0;
+        const auto countRanges = [&counter, &numIncorrect](const auto& kernel) {
+            const int numRanges = counter.numRanges;
+            kernel();
+            numIncorrect += counter.numRanges == numRanges;
+        };
+        countRanges([&] { Stealth::Tensor::cumsum<0>(scanned, executorTest0); });
+        countRanges([&] { Stealth::Tensor::cumsum<1>(scanned, executorTest0); });
+        countRanges([&] { Stealth::Tensor::SummedAreaTable<float, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> table{executorTest0}; });
+        countRanges([&] { Stealth::Tensor::Pyramid<float, kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT, 3> pyramid{executorTest0}; });
+        countRanges([&] { Stealth::Tensor::scatter_add(density, positions, 1); });
+        numIncorrect += density(0) != kTEST_SIZE;
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " kernels bypassed the executor."};
+    }
+} /* Executors */
+
+bool testExecutors() {
+    bool allTestsPassed = true;
+    allTestsPassed &= runTest(Executors::testWorkStealing);
+    allTestsPassed &= runTest(Executors::testCustomExecutor);
+    allTestsPassed &= runTest(Executors::testExecutorCoverage);
     return allTestsPassed;
 }
 
@@ -283,6 +1820,60 @@ namespace Storage {
     }
 
 
+    TestResult testZeroInitialized() {
+        int numIncorrect = 0;
+        // Reallocate a few times so that freed, dirty memory is likely to be handed back.
+        for (int i = 0; i < 3; ++i) {
+            Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> storageTest0;
+            for (int j = 0; j < storageTest0.size(); ++j) {
+                numIncorrect += storageTest0(j) != 0.0f;
+                storageTest0(j) = j + 1;
+            }
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testUninitializedConstruction() {
+        auto storageTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> storageTest1{Stealth::Tensor::kUNINITIALIZED};
+        storageTest1 = storageTest0 * 2.0f;
+        // Constructing from an expression skips the zero-fill too.
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> storageTest2 = storageTest1 + storageTest0;
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> storageTest3 = storageTest2;
+        int numIncorrect = 0;
+        for (int i = 0; i < storageTest0.size(); ++i) {
+            numIncorrect += storageTest1(i) != storageTest0(i) * 2.0f;
+            numIncorrect += storageTest3(i) != storageTest0(i) * 3.0f;
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
+    TestResult testStreamingAssignment() {
+        auto storageTest0 = SequentialTensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT>();
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH, kTEST_LENGTH, kTEST_HEIGHT> storageTest1;
+        Stealth::Tensor::Tensor3F<kTEST_WIDTH / 2, kTEST_LENGTH / 2, kTEST_HEIGHT / 2> storageTest2;
+        constexpr auto kSTREAMING = Stealth::Tensor::StorePolicy::Streaming;
+        int numIncorrect = 0;
+        // 1D, then 3D through an offset block, then a scalar fill.
+        storageTest1.assign<kSTREAMING>(storageTest0 * 2.0f);
+        for (int i = 0; i < storageTest0.size(); ++i) {
+            numIncorrect += storageTest1(i) != storageTest0(i) * 2.0f;
+        }
+        storageTest2.assign<kSTREAMING>(Stealth::Tensor::block<kTEST_WIDTH / 2, kTEST_LENGTH / 2, kTEST_HEIGHT / 2>(storageTest0, 1, 2, 3));
+        for (int k = 0; k < storageTest2.height(); ++k) {
+            for (int j = 0; j < storageTest2.length(); ++j) {
+                for (int i = 0; i < storageTest2.width(); ++i) {
+                    numIncorrect += storageTest2(i, j, k) != storageTest0(i + 1, j + 2, k + 3);
+                }
+            }
+        }
+        storageTest1.assign<kSTREAMING>(5.0f);
+        for (int i = 0; i < storageTest1.size(); ++i) {
+            numIncorrect += storageTest1(i) != 5.0f;
+        }
+        return TestResult{!numIncorrect, std::to_string(numIncorrect) + " values incorrect."};
+    }
+
     TestResult testInitializerListAssignment() {
         auto storageTest0 = Stealth::Tensor::VectorI<5>{};
         storageTest0 = {0.f, 1.f, 2.f, 3.f, 4.f};
@@ -299,6 +1890,9 @@ bool testStorage() {
     bool allTestsPassed = true;
     allTestsPassed &= runTest(Storage::testDenseStorageSmall);
     allTestsPassed &= runTest(Storage::testDenseStorageLarge);
+    allTestsPassed &= runTest(Storage::testZeroInitialized);
+    allTestsPassed &= runTest(Storage::testUninitializedConstruction);
+    allTestsPassed &= runTest(Storage::testStreamingAssignment);
     allTestsPassed &= runTest(Storage::testInitializerListAssignment);
     return allTestsPassed;
 }
@@ -306,8 +1900,26 @@ bool testStorage() {
 int main() {
     bool allTestsPassed = true;
     allTestsPassed &= testBlockOps();
+    allTestsPassed &= testViewOps();
     allTestsPassed &= testPerf();
     allTestsPassed &= testBinary();
+    allTestsPassed &= testSelect();
+    allTestsPassed &= testGatherScatter();
+    allTestsPassed &= testSummedArea();
+    allTestsPassed &= testScan();
+    allTestsPassed &= testDirty();
+    allTestsPassed &= testFused();
+    allTestsPassed &= testRewrite();
+    allTestsPassed &= testTiles();
+    allTestsPassed &= testLabels();
+    allTestsPassed &= testDistance();
+    allTestsPassed &= testFlow();
+    allTestsPassed &= testLayouts();
+    allTestsPassed &= testRing();
+    allTestsPassed &= testCompressed();
+    allTestsPassed &= testDispatch();
+    allTestsPassed &= testIndexing();
+    allTestsPassed &= testExecutors();
     allTestsPassed &= testStorage();
     if (allTestsPassed) {
         std::cout << "All tests passed!" << '\n';